@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "pretty_diagnostics/line_index.hpp"
+
+using namespace pretty_diagnostics;
+
+constexpr size_t DEFAULT_SIZE = 256 * 1024 * 1024;
+constexpr size_t REPETITIONS = 5;
+
+// Generates source-like text with lines between 0 and 119 characters
+static std::string generate_contents(const size_t size) {
+    std::string contents;
+    contents.reserve(size);
+
+    uint32_t state = 42;
+    while (contents.size() < size) {
+        state = state * 1664525 + 1013904223;
+        contents.append((state >> 16) % 120, 'x');
+        contents.push_back('\n');
+    }
+
+    contents.resize(size);
+    return contents;
+}
+
+// The byte-at-a-time loop that was used to build the line starts before the kernels existed
+static void baseline_line_starts(const std::string_view input, std::vector<size_t>& line_starts) {
+    for (size_t index = 0; index < input.size(); ++index) {
+        if (input[index] == '\n') {
+            line_starts.push_back(index + 1);
+        }
+    }
+}
+
+static void measure(const std::string& name, const std::string& contents, const std::function<size_t()>& function) {
+    auto best = std::chrono::duration<double>::max();
+    size_t result = 0;
+
+    for (size_t repetition = 0; repetition < REPETITIONS; ++repetition) {
+        const auto start = std::chrono::steady_clock::now();
+        result = function();
+        best = std::min<std::chrono::duration<double>>(best, std::chrono::steady_clock::now() - start);
+    }
+
+    const auto throughput = static_cast<double>(contents.size()) / best.count() / 1e9;
+    std::cout << std::left << std::setw(28) << name
+              << std::right << std::setw(8) << std::fixed << std::setprecision(2) << throughput << " GB/s"
+              << "  (" << result << " lines)\n";
+}
+
+int main(int argc, char** argv) {
+    const auto size = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_SIZE;
+    const auto contents = generate_contents(size);
+
+    std::cout << "Indexing " << contents.size() / (1024 * 1024) << " MiB, best of " << REPETITIONS << " runs\n";
+
+    measure("baseline loop", contents, [&] {
+        std::vector<size_t> line_starts = { 0 };
+        baseline_line_starts(contents, line_starts);
+        return line_starts.size();
+    });
+
+    const std::pair<std::string, ScanKernel> kernels[] = {
+        { "portable", ScanKernel::Portable },
+        { "sse2", ScanKernel::SSE2 },
+        { "avx2", ScanKernel::AVX2 },
+    };
+
+    for (const auto& [name, kernel] : kernels) {
+        if (!is_kernel_supported(kernel)) {
+            std::cout << std::left << std::setw(28) << name << "not supported\n";
+            continue;
+        }
+
+        measure("count_newlines " + name, contents, [&] { return count_newlines(contents, kernel); });
+        measure("find_line_starts " + name, contents, [&] {
+            std::vector<size_t> line_starts = { 0 };
+            find_line_starts(contents, 0, line_starts, kernel);
+            return line_starts.size();
+        });
+    }
+
+    for (const size_t threads : { 1, 2, 4, 8 }) {
+        measure("LineIndex " + std::to_string(threads) + " threads", contents, [&] {
+            const auto index = LineIndex(contents, { .threads = threads });
+            return index.line_count();
+        });
+    }
+
+    return 0;
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <filesystem>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "source.hpp"
+#include "utils.hpp"
+
+namespace pretty_diagnostics {
+/**
+ * @brief Configuration options for the windows of a `ChunkedFileSource`
+ */
+struct WindowConfig {
+    /**
+     * @brief Size in bytes of a single window, the unit in which the file is read
+     *
+     * Defaults to 1 MiB
+     */
+    size_t window_size = 1024 * 1024;
+
+    /**
+     * @brief Number of windows that are kept in memory at the same time
+     *
+     * Once exceeded, the least recently used window is released
+     */
+    size_t max_windows = 16;
+};
+
+/**
+ * @brief A `Source` implementation that reads a file on demand through a bounded set of windows
+ *
+ * The file is split into fixed-size windows that are read with positioned reads whenever they
+ * are needed, only the most recently used ones are kept in memory. Instead of the start of every
+ * line, the source only remembers how many lines precede each window, the rest is recounted from
+ * a single window. Memory usage is therefore bounded by the window budget plus a few bytes per
+ * window, no matter how large the file is.
+ *
+ * Lines and substrings are copied out of the windows. A view points into its window, or into
+ * a copy if it spans several of them, and stays valid until the next call on the source. While
+ * a `pin()` is held, the windows and copies behind every view are kept on top of the window
+ * budget, and they are released together with the last pin. Columns are counted while streaming
+ * through the windows, so not even a single line has to be held in memory at once. The whole
+ * contents are never held in memory either, `contents()` and `contents_view()` are not supported.
+ * The file must not change while the source is in use
+ */
+class ChunkedFileSource final : public Source {
+public:
+    /**
+     * @brief Opens a file from a filesystem path
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     * @param working_path Optional path to make the path relative
+     * @param config Options that control the windows
+     */
+    explicit ChunkedFileSource(const std::filesystem::path& path, const std::filesystem::path& working_path = std::filesystem::current_path(),
+                               const WindowConfig& config = {});
+
+    ChunkedFileSource(const ChunkedFileSource&) = delete;
+    ChunkedFileSource& operator=(const ChunkedFileSource&) = delete;
+
+    /**
+     * @brief Maps (row, column) to a `Location` within the file
+     *
+     * @param row 0-based line number
+     * @param column 0-based column number
+     *
+     * @return Location corresponding to the given coordinates
+     */
+    [[nodiscard]] Location from_coords(size_t row, size_t column) const override;
+
+    /**
+     * @brief Maps an absolute index to a `Location` within the file
+     *
+     * @param index 0-based absolute character index
+     *
+     * @return Location corresponding to the given index
+     */
+    [[nodiscard]] Location from_index(size_t index) const override;
+
+    /**
+     * @brief Extracts the substring between two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return Substring between @p start and @p end
+     */
+    [[nodiscard]] std::string substr(const Location& start, const Location& end) const override;
+
+    /**
+     * @brief Returns a view of the text between two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return View of the text, valid until the next call on the source or while it is pinned
+     */
+    [[nodiscard]] std::string_view substr_view(const Location& start, const Location& end) const override;
+
+    /**
+     * @brief Returns the full line containing the given location
+     *
+     * @param location A location within the desired line
+     *
+     * @return The entire line contents without a trailing newline
+     */
+    [[nodiscard]] std::string line(const Location& location) const override;
+
+    /**
+     * @brief Returns the contents of the specified line number
+     *
+     * @param line_number 0-based line number
+     *
+     * @return The entire line contents without a trailing newline
+     */
+    [[nodiscard]] std::string line(size_t line_number) const override;
+
+    /**
+     * @brief Returns a view of the full line containing the given location
+     *
+     * @param location A location within the desired line
+     *
+     * @return View of the line, valid until the next call on the source or while it is pinned
+     */
+    [[nodiscard]] std::string_view line_view(const Location& location) const override;
+
+    /**
+     * @brief Returns a view of the specified line number
+     *
+     * @param line_number 0-based line number
+     *
+     * @return View of the line, valid until the next call on the source or while it is pinned
+     */
+    [[nodiscard]] std::string_view line_view(size_t line_number) const override;
+
+    /**
+     * @brief Returns the number of lines in the file
+     *
+     * Reads the whole file once, but never keeps more than one window of it for counting
+     *
+     * @return Line count
+     */
+    [[nodiscard]] size_t line_count() const override;
+
+    /**
+     * @brief Checks whether the file has the given line, reading only as far as necessary
+     *
+     * @param line_number 0-based line number
+     *
+     * @return True if @p line_number is smaller than the line count
+     */
+    [[nodiscard]] bool has_line(size_t line_number) const override;
+
+    /**
+     * @brief Returns the absolute index at which the given line starts
+     *
+     * @param line_number 0-based line number
+     *
+     * @return 0-based index of the first character of the line
+     */
+    [[nodiscard]] size_t line_start(size_t line_number) const override;
+
+    /**
+     * @brief Converts a column in the given line from one unit into another
+     *
+     * The line is streamed from its start up to the column, without copying it or pinning a window
+     *
+     * @param line_number 0-based line number
+     * @param column 0-based column in @p from
+     * @param from Unit of @p column
+     * @param to Unit of the returned column
+     *
+     * @return 0-based column in @p to
+     */
+    [[nodiscard]] size_t convert_column(size_t line_number, size_t column, ColumnUnit from, ColumnUnit to) const override;
+
+    /**
+     * @brief Not supported, the whole file is never held in memory
+     *
+     * @throws std::runtime_error Always, use `substr()` or `substr_view()` on a range instead
+     */
+    [[nodiscard]] const std::string& contents() const override;
+
+    /**
+     * @brief Not supported, the whole file is never held in memory
+     *
+     * @throws std::runtime_error Always, use `substr()` or `substr_view()` on a range instead
+     */
+    [[nodiscard]] std::string_view contents_view() const override;
+
+    /**
+     * @brief Keeps the windows and copies behind the views of the source in memory
+     *
+     * @return Handle that releases them once it is the last pin to be dropped
+     */
+    [[nodiscard]] std::shared_ptr<const void> pin() const override;
+
+    /**
+     * @brief Returns a displayable path or identifier of the source
+     *
+     * @return Display path or identifier
+     */
+    [[nodiscard]] std::string path() const override;
+
+    /**
+     * @brief Returns the total size (in characters) of the file
+     *
+     * @return Size in characters
+     */
+    [[nodiscard]] size_t size() const override;
+
+    /**
+     * @brief Returns the heap memory held by the windows, the line checkpoints and the views
+     *
+     * @return Allocated bytes, including the windows that are kept for views
+     */
+    [[nodiscard]] size_t memory_usage() const;
+
+private:
+    /**
+     * @brief Owns a file opened for positioned reads and closes it on destruction
+     */
+    struct File {
+        explicit File(const std::filesystem::path& path);
+        ~File();
+
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+
+        void read(char* output, size_t count, size_t offset) const;
+
+#ifdef _WIN32
+        void* handle = nullptr;
+#else
+        int descriptor = -1;
+#endif
+        size_t size = 0;
+    };
+
+    /**
+     * @brief Streams a line from its start through a buffer of about one window
+     */
+    struct LineStream {
+        LineStream(const ChunkedFileSource& source, size_t start);
+
+        [[nodiscard]] std::string_view ahead(size_t count);
+
+        [[nodiscard]] VisualChar visual_char();
+
+        const ChunkedFileSource& source;
+        std::string buffer;
+        size_t start, buffer_offset, offset;
+        bool ended;
+    };
+
+    /**
+     * @brief A resident window together with its number
+     */
+    struct Window {
+        size_t number;
+        std::shared_ptr<const std::string> data;
+    };
+
+    [[nodiscard]] const std::shared_ptr<const std::string>& _window(size_t number) const;
+
+    [[nodiscard]] std::string_view _view(size_t start, size_t end) const;
+
+    [[nodiscard]] size_t _window_count() const;
+
+    void _scan_windows(size_t count) const;
+
+    void _scan_to_row(size_t row) const;
+
+    [[nodiscard]] bool _contains_row(size_t row) const;
+
+    [[nodiscard]] size_t _row(size_t index) const;
+
+    [[nodiscard]] size_t _line_start(size_t row) const;
+
+    [[nodiscard]] std::string _read(size_t start, size_t end) const;
+
+    [[nodiscard]] std::pair<size_t, size_t> _line_range(size_t row) const;
+
+    [[nodiscard]] std::string _line(size_t row) const;
+
+    [[nodiscard]] size_t _to_column(size_t row, size_t byte_column, ColumnUnit unit) const;
+
+    [[nodiscard]] size_t _from_column(size_t row, size_t column, ColumnUnit unit) const;
+
+    void _unpin() const;
+
+private:
+    std::string _display_path;
+    File _file;
+    size_t _window_size, _max_windows;
+
+    mutable std::list<Window> _windows;
+    mutable std::unordered_map<size_t, std::list<Window>::iterator> _window_lookup;
+    mutable std::unordered_map<size_t, std::shared_ptr<const std::string>> _pinned_windows;
+    mutable std::map<std::pair<size_t, size_t>, std::string> _spanning_views;
+    mutable std::shared_ptr<const std::string> _last_window;
+    mutable std::string _last_view;
+    mutable std::vector<size_t> _rows_before;
+    mutable size_t _pins;
+    mutable std::mutex _mutex;
+};
+} // namespace pretty_diagnostics
+
+/**
+ * @brief Streams a readable description of a `ChunkedFileSource`
+ *
+ * @param os Output stream to write to
+ * @param source Source to describe
+ *
+ * @return Reference to @p os.
+ */
+std::ostream& operator<<(std::ostream& os, const pretty_diagnostics::ChunkedFileSource& source);
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
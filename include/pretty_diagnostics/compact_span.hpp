@@ -0,0 +1,247 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "span.hpp"
+
+namespace pretty_diagnostics {
+/**
+ * @brief A 12-byte span that refers to its source by id, for data structures that keep many spans
+ *
+ * Only the source id and the byte offsets are stored, rows and columns are resolved on demand
+ * against the `SourceTable` that assigned the id. Sources are therefore limited to 4 GiB
+ */
+class CompactSpan {
+public:
+    /**
+     * @brief Constructs an empty span at the start of the source with id 0
+     */
+    CompactSpan() = default;
+
+    /**
+     * @brief Constructs a span from byte offsets into a registered source
+     *
+     * @param source_id Id of the source within its `SourceTable`
+     * @param start_index 0-based start index (inclusive)
+     * @param end_index 0-based end index (exclusive)
+     */
+    CompactSpan(uint32_t source_id, uint32_t start_index, uint32_t end_index);
+
+    /**
+     * @brief Orders spans by their source id and start index
+     *
+     * @param lhs Left-hand span
+     * @param rhs Right-hand span
+     *
+     * @return True if @p lhs comes before @p rhs
+     */
+    friend bool operator<(const CompactSpan& lhs, const CompactSpan& rhs) {
+        return lhs._source_id != rhs._source_id ? lhs._source_id < rhs._source_id : lhs._start_index < rhs._start_index;
+    }
+
+    /**
+     * @brief Equality compares source id, start and end
+     *
+     * @param lhs Left-hand span
+     * @param rhs Right-hand span
+     *
+     * @return True if both spans cover the same range of the same source
+     */
+    friend bool operator==(const CompactSpan& lhs, const CompactSpan& rhs) = default;
+
+    /**
+     * @brief Combines this span with another span of the same source into a single continuous span
+     *
+     * @param other The span to combine with
+     *
+     * @return A new span that encompasses both spans
+     * @throws std::runtime_error If the spans belong to different sources
+     */
+    [[nodiscard]] CompactSpan join(const CompactSpan& other) const;
+
+    /**
+     * @brief Returns true if this span intersects the other span
+     *
+     * @param other Other span to test against
+     *
+     * @return True if both spans belong to the same source and overlap
+     */
+    [[nodiscard]] bool intersects(const CompactSpan& other) const;
+
+    /**
+     * @brief Returns the number of bytes covered by this span
+     *
+     * @return Span width in bytes
+     */
+    [[nodiscard]] size_t width() const { return _end_index - _start_index; }
+
+    /**
+     * @brief Returns the id of the backing source
+     *
+     * @return Id of the source within its `SourceTable`
+     */
+    [[nodiscard]] uint32_t source_id() const { return _source_id; }
+
+    /**
+     * @brief Returns the byte offset at which the span starts
+     *
+     * @return 0-based start index (inclusive)
+     */
+    [[nodiscard]] uint32_t start_index() const { return _start_index; }
+
+    /**
+     * @brief Returns the byte offset at which the span ends
+     *
+     * @return 0-based end index (exclusive)
+     */
+    [[nodiscard]] uint32_t end_index() const { return _end_index; }
+
+private:
+    uint32_t _source_id = 0;
+    uint32_t _start_index = 0, _end_index = 0;
+};
+
+/**
+ * @brief Assigns 32-bit ids to sources, so spans can refer to them without a pointer
+ *
+ * The table keeps every registered source alive for its own lifetime, which also makes it
+ * a safe owner for non-owning handles, see `borrow()`. Registering and resolving are safe
+ * to be called concurrently
+ */
+class SourceTable {
+public:
+    /**
+     * @brief Registers a source, returning its existing id if it was registered before
+     *
+     * @param source Source to register
+     *
+     * @return Id of @p source within this table
+     * @throws std::runtime_error If the table is full
+     */
+    uint32_t add(const std::shared_ptr<Source>& source);
+
+    /**
+     * @brief Returns the source with the given id
+     *
+     * @param source_id Id returned by `add()`
+     *
+     * @return The registered source, valid for the lifetime of the table
+     * @throws std::runtime_error If no source has the id
+     */
+    [[nodiscard]] const std::shared_ptr<Source>& source(uint32_t source_id) const;
+
+    /**
+     * @brief Returns a non-owning handle to the source with the given id
+     *
+     * Spans built from the handle can be created and copied without touching the reference
+     * count of the source, but must not outlive the table
+     *
+     * @param source_id Id returned by `add()`
+     *
+     * @return Handle created with `pretty_diagnostics::borrow()`
+     * @throws std::runtime_error If no source has the id
+     */
+    [[nodiscard]] std::shared_ptr<Source> borrow(uint32_t source_id) const;
+
+    /**
+     * @brief Converts a span into its compact form, registering its source if necessary
+     *
+     * @param span Span to convert
+     *
+     * @return Compact span covering the same range
+     * @throws std::runtime_error If the span ends beyond 4 GiB
+     */
+    [[nodiscard]] CompactSpan compact(const Span& span);
+
+    /**
+     * @brief Resolves a compact span into a full span with rows and columns
+     *
+     * @param span Compact span with an id of this table
+     *
+     * @return Span covering the same range
+     */
+    [[nodiscard]] Span resolve(const CompactSpan& span) const;
+
+    /**
+     * @brief Resolves a compact span into a full span that doesn't own its source
+     *
+     * @param span Compact span with an id of this table
+     *
+     * @return Span covering the same range, valid for the lifetime of the table
+     */
+    [[nodiscard]] Span resolve_borrowed(const CompactSpan& span) const;
+
+    /**
+     * @brief Resolves the start of a compact span
+     *
+     * @param span Compact span with an id of this table
+     *
+     * @return Location of the first byte of the span
+     */
+    [[nodiscard]] Location start(const CompactSpan& span) const;
+
+    /**
+     * @brief Resolves the end of a compact span
+     *
+     * @param span Compact span with an id of this table
+     *
+     * @return Location directly after the last byte of the span
+     */
+    [[nodiscard]] Location end(const CompactSpan& span) const;
+
+    /**
+     * @brief Returns the number of registered sources
+     *
+     * @return Source count
+     */
+    [[nodiscard]] size_t size() const;
+
+private:
+    std::deque<std::shared_ptr<Source>> _sources;
+    std::unordered_map<const Source*, uint32_t> _ids;
+    mutable std::shared_mutex _mutex;
+};
+} // namespace pretty_diagnostics
+
+/**
+ * @brief Streams a human-readable representation of a compact span for debugging
+ *
+ * @param os Output stream to write to
+ * @param span Span to format
+ *
+ * @return Reference to @p os
+ */
+std::ostream& operator<<(std::ostream& os, const pretty_diagnostics::CompactSpan& span);
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "source.hpp"
+
+namespace pretty_diagnostics {
+/**
+ * @brief A `Source` implementation for buffers that change, e.g. in an editor
+ *
+ * The contents are kept as a piece table: a sequence of pieces that each reference a
+ * range of an immutable text buffer. Every buffer knows where its own lines start, so an
+ * edit only creates a buffer for the inserted text and replaces the pieces around the
+ * edited range, neither the untouched text is copied nor its lines rescanned.
+ *
+ * Edits change the source in place and invalidate all views, references and locations
+ * that were obtained from it before. Spans that have to stay valid for a specific version
+ * should be created against a `snapshot()` of it, which shares the text buffers and is
+ * never edited. Reading a source concurrently is safe, editing it while it is read is not
+ */
+class EditableSource final : public Source {
+public:
+    /**
+     * @brief Creates an editable source with an optional display path
+     *
+     * @param contents Initial contents
+     * @param display_path Optional display path used in diagnostics
+     */
+    explicit EditableSource(std::string contents, std::string display_path = "<memory>");
+
+    EditableSource& operator=(const EditableSource&) = delete;
+
+    /**
+     * @brief Replaces the text between two indices
+     *
+     * An empty range inserts the replacement, an empty replacement deletes the range
+     *
+     * @param start_index 0-based start index (inclusive)
+     * @param end_index 0-based end index (exclusive)
+     * @param replacement Text that is inserted in place of the range
+     *
+     * @throws std::runtime_error If the range is invalid
+     */
+    void edit(size_t start_index, size_t end_index, std::string_view replacement);
+
+    /**
+     * @brief Replaces the text between two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     * @param replacement Text that is inserted in place of the range
+     *
+     * @throws std::runtime_error If the range is invalid
+     */
+    void edit(const Location& start, const Location& end, std::string_view replacement);
+
+    /**
+     * @brief Returns an independent copy of the current version
+     *
+     * The copy shares the text buffers with this source, so it costs one pointer per piece
+     *
+     * @return Source that keeps the current contents, even when this source is edited
+     */
+    [[nodiscard]] std::shared_ptr<EditableSource> snapshot() const;
+
+    /**
+     * @brief Returns the number of edits applied to the contents so far
+     *
+     * @return Version of the contents, starting at 0
+     */
+    [[nodiscard]] size_t version() const { return _version; }
+
+    /**
+     * @brief Returns the number of pieces the contents consist of
+     *
+     * @return Piece count, 0 for empty contents
+     */
+    [[nodiscard]] size_t piece_count() const { return _pieces.size(); }
+
+    /**
+     * @brief Maps (row, column) to a `Location` within the source
+     *
+     * @param row 0-based line number
+     * @param column 0-based column number
+     *
+     * @return Location corresponding to the given coordinates
+     */
+    [[nodiscard]] Location from_coords(size_t row, size_t column) const override;
+
+    /**
+     * @brief Maps an absolute index to a `Location` within the source
+     *
+     * @param index 0-based absolute character index
+     *
+     * @return Location corresponding to the given index
+     */
+    [[nodiscard]] Location from_index(size_t index) const override;
+
+    /**
+     * @brief Extracts the substring between two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return Substring between @p start and @p end
+     */
+    [[nodiscard]] std::string substr(const Location& start, const Location& end) const override;
+
+    /**
+     * @brief Returns a view of the text between two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return View of the text, valid until the next edit
+     */
+    [[nodiscard]] std::string_view substr_view(const Location& start, const Location& end) const override;
+
+    /**
+     * @brief Returns the full line containing the given location
+     *
+     * @param location A location within the desired line
+     *
+     * @return The entire line contents without a trailing newline
+     */
+    [[nodiscard]] std::string line(const Location& location) const override;
+
+    /**
+     * @brief Returns the contents of the specified line number
+     *
+     * @param line_number 0-based line number
+     *
+     * @return The entire line contents without a trailing newline
+     */
+    [[nodiscard]] std::string line(size_t line_number) const override;
+
+    /**
+     * @brief Returns a view of the full line containing the given location
+     *
+     * @param location A location within the desired line
+     *
+     * @return View of the line without a trailing newline, valid until the next edit
+     */
+    [[nodiscard]] std::string_view line_view(const Location& location) const override;
+
+    /**
+     * @brief Returns a view of the specified line number
+     *
+     * @param line_number 0-based line number
+     *
+     * @return View of the line without a trailing newline, valid until the next edit
+     */
+    [[nodiscard]] std::string_view line_view(size_t line_number) const override;
+
+    /**
+     * @brief Returns the number of lines in the source
+     *
+     * @return Line count
+     */
+    [[nodiscard]] size_t line_count() const override;
+
+    /**
+     * @brief Returns the absolute index at which the given line starts
+     *
+     * @param line_number 0-based line number
+     *
+     * @return 0-based index of the first character of the line
+     */
+    [[nodiscard]] size_t line_start(size_t line_number) const override;
+
+    /**
+     * @brief Returns the entire contents of the source
+     *
+     * The contents are assembled from the pieces on the first call after an edit
+     *
+     * @return Full source contents, valid until the next edit
+     */
+    [[nodiscard]] const std::string& contents() const override;
+
+    /**
+     * @brief Returns a view of the entire contents of the source
+     *
+     * @return View of the full source contents, valid until the next edit
+     */
+    [[nodiscard]] std::string_view contents_view() const override;
+
+    /**
+     * @brief Returns a displayable path or identifier of the source
+     *
+     * @return Display path or identifier
+     */
+    [[nodiscard]] std::string path() const override;
+
+    /**
+     * @brief Returns the total size (in characters) of the source
+     *
+     * @return Size in characters
+     */
+    [[nodiscard]] size_t size() const override;
+
+private:
+    /**
+     * @brief An immutable text buffer together with the offsets following each of its line breaks
+     */
+    struct Buffer {
+        explicit Buffer(std::string text);
+
+        [[nodiscard]] size_t newlines(size_t start, size_t end) const;
+
+        std::string text;
+        std::vector<size_t> line_starts;
+    };
+
+    /**
+     * @brief A range of a buffer together with the number of line breaks in it
+     */
+    struct Piece {
+        std::shared_ptr<const Buffer> buffer;
+        size_t start, length, newlines;
+    };
+
+    EditableSource(const EditableSource& other);
+
+    [[nodiscard]] static Piece _make_piece(const std::shared_ptr<const Buffer>& buffer, size_t start, size_t length);
+
+    void _update_prefixes(size_t first_piece);
+
+    void _flatten();
+
+    void _invalidate_caches();
+
+    [[nodiscard]] size_t _piece_at(size_t index) const;
+
+    [[nodiscard]] size_t _row(size_t index) const;
+
+    [[nodiscard]] size_t _line_start(size_t row) const;
+
+    [[nodiscard]] size_t _line_end(size_t row) const;
+
+    [[nodiscard]] std::string_view _view(size_t start, size_t end) const;
+
+    [[nodiscard]] std::string _read(size_t start, size_t end) const;
+
+private:
+    std::string _display_path;
+    std::vector<Piece> _pieces;
+    std::vector<size_t> _piece_starts, _piece_rows;
+    size_t _version;
+
+    mutable std::optional<std::string> _contents;
+    mutable std::unordered_map<size_t, std::string> _materialized;
+    mutable std::mutex _cache_mutex;
+};
+} // namespace pretty_diagnostics
+
+/**
+ * @brief Streams a readable description of an `EditableSource`
+ *
+ * @param os Output stream to write to
+ * @param source Source to describe
+ *
+ * @return Reference to @p os.
+ */
+std::ostream& operator<<(std::ostream& os, const pretty_diagnostics::EditableSource& source);
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "source.hpp"
+#include "span.hpp"
+
+namespace pretty_diagnostics {
+/**
+ * @brief A range of generated text together with the range of the source it was expanded from
+ */
+struct ExpansionRange {
+    size_t start, end;               ///< Range within the generated text, end is exclusive
+    std::shared_ptr<Source> parent;  ///< Source the text was expanded from
+    size_t parent_start, parent_end; ///< Range within @p parent, end is exclusive
+};
+
+/**
+ * @brief A `Source` implementation for generated text, e.g. the output of a preprocessor
+ *
+ * Besides its contents, the source keeps a table that maps ranges of the generated text back
+ * to the ranges of the sources they were expanded from. A parent can be an expansion itself,
+ * so a position of macro expanded code is traced back through every layer of expansion by
+ * following the parents until a source without mappings is reached.
+ *
+ * If a mapped range has the same length as its parent range, the text was copied, e.g. an
+ * argument of a macro, and every index maps to the index at the same offset in the parent.
+ * Otherwise, e.g. for the body of a macro that maps to its invocation, every index maps to
+ * the whole parent range. The table is sorted by the generated ranges and looked up by a
+ * binary search, each entry only stores four offsets and the id of its parent
+ */
+class ExpansionSource final : public StringSource {
+public:
+    /**
+     * @brief Creates a generated source without any mappings
+     *
+     * @param contents Generated text
+     * @param display_path Optional display identifier for diagnostics output
+     * @param config Options that control how the line index is built
+     */
+    explicit ExpansionSource(std::string contents, std::string display_path = "<expansion>", const IndexConfig& config = {});
+
+    /**
+     * @brief Records that a range of the generated text was expanded from a range of a parent
+     *
+     * Ranges have to be mapped in ascending order and must not overlap
+     *
+     * @param start 0-based start index within the generated text (inclusive)
+     * @param end 0-based end index within the generated text (exclusive)
+     * @param parent Source the text was expanded from
+     * @param parent_start 0-based start index within @p parent (inclusive)
+     * @param parent_end 0-based end index within @p parent (exclusive)
+     *
+     * @throws std::runtime_error If a range is invalid or out of order, or @p parent is null
+     */
+    void map(size_t start, size_t end, std::shared_ptr<Source> parent, size_t parent_start, size_t parent_end);
+
+    /**
+     * @brief Looks up the mapping that contains an index of the generated text
+     *
+     * @param index 0-based index within the generated text
+     *
+     * @return The mapped range containing @p index, or `std::nullopt` if it isn't mapped
+     */
+    [[nodiscard]] std::optional<ExpansionRange> find(size_t index) const;
+
+    /**
+     * @brief Translates a span of the generated text into the source it was expanded from
+     *
+     * A span that covers several mappings of the same parent is translated into a span from
+     * the first to the last of them, otherwise only the mapping of its start is used
+     *
+     * @param span Span within this source
+     *
+     * @return Span within the parent, or `std::nullopt` if the start of @p span isn't mapped
+     * @throws std::runtime_error If @p span belongs to another source
+     */
+    [[nodiscard]] std::optional<Span> to_parent(const Span& span) const;
+
+    /**
+     * @brief Returns the number of mapped ranges
+     *
+     * @return Number of entries in the mapping table
+     */
+    [[nodiscard]] size_t mapping_count() const { return _mappings.size(); }
+
+private:
+    /**
+     * @brief A single entry of the mapping table
+     */
+    struct Mapping {
+        size_t start, end;
+        size_t parent_start, parent_end;
+        uint32_t parent;
+    };
+
+    [[nodiscard]] const Mapping* _find(size_t index) const;
+
+    [[nodiscard]] static size_t _to_parent(const Mapping& mapping, size_t index, bool is_end);
+
+private:
+    std::vector<Mapping> _mappings;
+    std::vector<std::shared_ptr<Source>> _parents;
+    std::unordered_map<const Source*, uint32_t> _parent_ids;
+};
+
+/**
+ * @brief Follows a span through every layer of expansion it was generated from
+ *
+ * @param span Span within any source
+ *
+ * @return The spans it was expanded from, innermost first, empty if @p span isn't expanded
+ */
+[[nodiscard]] std::vector<Span> expansion_chain(const Span& span);
+
+/**
+ * @brief Resolves a span to the location it was originally spelled at
+ *
+ * @param span Span within any source
+ *
+ * @return The outermost span of the expansion chain, or @p span itself if it isn't expanded
+ */
+[[nodiscard]] Span spelling_span(const Span& span);
+} // namespace pretty_diagnostics
+
+/**
+ * @brief Streams a readable description of an `ExpansionSource`
+ *
+ * @param os Output stream to write to
+ * @param source Source to describe
+ *
+ * @return Reference to @p os.
+ */
+std::ostream& operator<<(std::ostream& os, const pretty_diagnostics::ExpansionSource& source);
+
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,470 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace pretty_diagnostics {
+/**
+ * @brief An ordered map that keeps its entries sorted in one contiguous vector
+ *
+ * Lookups are binary searches and iterating touches consecutive memory instead of chasing
+ * the nodes of a tree. Inserting behind the last key, which is the common case for labels
+ * added in source order, appends in O(1) amortized, inserting anywhere else shifts the
+ * entries behind it. Iterators and references are invalidated by every insertion or erasure.
+ *
+ * The entries are exposed as mutable pairs, so their keys must not be modified
+ *
+ * @tparam Key Type of the keys
+ * @tparam Value Type of the mapped values
+ * @tparam Compare Strict weak ordering of the keys
+ */
+template <typename Key, typename Value, typename Compare = std::less<>>
+class FlatMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    using container_type = std::pmr::vector<value_type>;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+    using reverse_iterator = typename container_type::reverse_iterator;
+    using const_reverse_iterator = typename container_type::const_reverse_iterator;
+    using size_type = typename container_type::size_type;
+
+public:
+    /**
+     * @brief Creates an empty map
+     *
+     * @param allocator Allocator of the entries
+     */
+    explicit FlatMap(const allocator_type& allocator = {}) :
+        _values(allocator) {
+    }
+
+    FlatMap(const FlatMap& other) = default;
+    FlatMap(FlatMap&& other) noexcept = default;
+
+    /**
+     * @brief Copies a map into the memory of another allocator
+     *
+     * @param other Map to copy
+     * @param allocator Allocator of the copied entries
+     */
+    FlatMap(const FlatMap& other, const allocator_type& allocator) :
+        _values(other._values, allocator) {
+    }
+
+    /**
+     * @brief Moves a map into the memory of another allocator
+     *
+     * @param other Map to move
+     * @param allocator Allocator of the moved entries
+     */
+    FlatMap(FlatMap&& other, const allocator_type& allocator) :
+        _values(std::move(other._values), allocator) {
+    }
+
+    FlatMap& operator=(const FlatMap& other) = default;
+    FlatMap& operator=(FlatMap&& other) noexcept = default;
+
+    /**
+     * @brief Inserts a value constructed from @p args, unless the key is already present
+     *
+     * @param key Key of the entry
+     * @param args Arguments the value is constructed from, followed by the allocator if it is allocator-aware
+     *
+     * @return Iterator to the entry of @p key and whether it was inserted
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        const auto position = lower_bound(key);
+        if (position != _values.end() && !_compare(key, position->first)) return { position, false };
+
+        const auto inserted = _values.emplace(position, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        return { inserted, true };
+    }
+
+    /**
+     * @brief Returns the value of a key
+     *
+     * @param key Key to look up
+     *
+     * @return Reference to the mapped value
+     * @throws std::out_of_range If @p key isn't present
+     */
+    [[nodiscard]] Value& at(const Key& key) {
+        const auto it = find(key);
+        if (it == _values.end()) throw std::out_of_range("FlatMap::at(): key is not present");
+        return it->second;
+    }
+
+    /**
+     * @brief Returns the value of a key
+     *
+     * @param key Key to look up
+     *
+     * @return Reference to the mapped value
+     * @throws std::out_of_range If @p key isn't present
+     */
+    [[nodiscard]] const Value& at(const Key& key) const {
+        const auto it = find(key);
+        if (it == _values.end()) throw std::out_of_range("FlatMap::at(): key is not present");
+        return it->second;
+    }
+
+    /**
+     * @brief Finds the entry of a key
+     *
+     * @param key Key to look up
+     *
+     * @return Iterator to the entry, or `end()` if @p key isn't present
+     */
+    [[nodiscard]] iterator find(const Key& key) {
+        const auto it = lower_bound(key);
+        return it != _values.end() && !_compare(key, it->first) ? it : _values.end();
+    }
+
+    /**
+     * @brief Finds the entry of a key
+     *
+     * @param key Key to look up
+     *
+     * @return Iterator to the entry, or `end()` if @p key isn't present
+     */
+    [[nodiscard]] const_iterator find(const Key& key) const {
+        const auto it = lower_bound(key);
+        return it != _values.end() && !_compare(key, it->first) ? it : _values.end();
+    }
+
+    /**
+     * @brief Checks whether a key is present
+     *
+     * @param key Key to look up
+     *
+     * @return True if there is an entry for @p key
+     */
+    [[nodiscard]] bool contains(const Key& key) const { return find(key) != _values.end(); }
+
+    /**
+     * @brief Returns the first entry whose key is not ordered before @p key
+     *
+     * @param key Key to look up
+     *
+     * @return Iterator to the entry, or `end()` if there is none
+     */
+    [[nodiscard]] iterator lower_bound(const Key& key) {
+        return std::ranges::lower_bound(_values, key, _compare, &value_type::first);
+    }
+
+    /**
+     * @brief Returns the first entry whose key is not ordered before @p key
+     *
+     * @param key Key to look up
+     *
+     * @return Iterator to the entry, or `end()` if there is none
+     */
+    [[nodiscard]] const_iterator lower_bound(const Key& key) const {
+        return std::ranges::lower_bound(_values, key, _compare, &value_type::first);
+    }
+
+    /**
+     * @brief Removes an entry
+     *
+     * @param position Iterator to the entry
+     *
+     * @return Iterator to the entry behind the removed one
+     */
+    iterator erase(const_iterator position) { return _values.erase(position); }
+
+    /**
+     * @brief Removes every entry that matches a predicate
+     *
+     * @param map Map to remove the entries from
+     * @param predicate Predicate that is called with every entry
+     *
+     * @return Number of removed entries
+     */
+    template <typename Predicate>
+    friend size_type erase_if(FlatMap& map, Predicate predicate) {
+        return std::erase_if(map._values, predicate);
+    }
+
+    /**
+     * @brief Reserves memory for the given number of entries
+     *
+     * @param capacity Number of entries
+     */
+    void reserve(const size_type capacity) { _values.reserve(capacity); }
+
+    /**
+     * @brief Removes all entries, but keeps the memory of the vector
+     */
+    void clear() { _values.clear(); }
+
+    [[nodiscard]] size_type size() const { return _values.size(); }
+    [[nodiscard]] size_type capacity() const { return _values.capacity(); }
+    [[nodiscard]] bool empty() const { return _values.empty(); }
+
+    [[nodiscard]] iterator begin() { return _values.begin(); }
+    [[nodiscard]] iterator end() { return _values.end(); }
+    [[nodiscard]] const_iterator begin() const { return _values.begin(); }
+    [[nodiscard]] const_iterator end() const { return _values.end(); }
+    [[nodiscard]] reverse_iterator rbegin() { return _values.rbegin(); }
+    [[nodiscard]] reverse_iterator rend() { return _values.rend(); }
+    [[nodiscard]] const_reverse_iterator rbegin() const { return _values.rbegin(); }
+    [[nodiscard]] const_reverse_iterator rend() const { return _values.rend(); }
+
+    /**
+     * @brief Returns the allocator of the entries
+     *
+     * @return Allocator the map was created with
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return _values.get_allocator(); }
+
+private:
+    container_type _values;
+    [[no_unique_address]] Compare _compare;
+};
+
+/**
+ * @brief An ordered set that keeps its values sorted in one contiguous vector
+ *
+ * The counterpart of `FlatMap` for sets. Values are only exposed as constant, since
+ * modifying them could break the order. Iterators and references are invalidated by every
+ * insertion or erasure
+ *
+ * @tparam T Type of the values
+ * @tparam Compare Strict weak ordering of the values
+ */
+template <typename T, typename Compare = std::less<>>
+class FlatSet {
+public:
+    using key_type = T;
+    using value_type = T;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    using container_type = std::pmr::vector<T>;
+    using iterator = typename container_type::const_iterator;
+    using const_iterator = typename container_type::const_iterator;
+    using reverse_iterator = typename container_type::const_reverse_iterator;
+    using const_reverse_iterator = typename container_type::const_reverse_iterator;
+    using size_type = typename container_type::size_type;
+
+public:
+    /**
+     * @brief Creates an empty set
+     *
+     * @param allocator Allocator of the values
+     */
+    explicit FlatSet(const allocator_type& allocator = {}) :
+        _values(allocator) {
+    }
+
+    FlatSet(const FlatSet& other) = default;
+    FlatSet(FlatSet&& other) noexcept = default;
+
+    /**
+     * @brief Copies a set into the memory of another allocator
+     *
+     * @param other Set to copy
+     * @param allocator Allocator of the copied values
+     */
+    FlatSet(const FlatSet& other, const allocator_type& allocator) :
+        _values(other._values, allocator) {
+    }
+
+    /**
+     * @brief Moves a set into the memory of another allocator
+     *
+     * @param other Set to move
+     * @param allocator Allocator of the moved values
+     */
+    FlatSet(FlatSet&& other, const allocator_type& allocator) :
+        _values(std::move(other._values), allocator) {
+    }
+
+    FlatSet& operator=(const FlatSet& other) = default;
+    FlatSet& operator=(FlatSet&& other) noexcept = default;
+
+    /**
+     * @brief Inserts a value, unless an equivalent one is already present
+     *
+     * @param value Value to insert
+     *
+     * @return Iterator to the equivalent value and whether @p value was inserted
+     */
+    std::pair<iterator, bool> insert(T value) {
+        // Values that arrive in order are appended without searching.
+        if (_values.empty() || _compare(_values.back(), value)) {
+            _values.push_back(std::move(value));
+            return { std::prev(_values.cend()), true };
+        }
+
+        const auto position = std::ranges::lower_bound(_values, value, _compare);
+        if (!_compare(value, *position)) return { position, false };
+
+        return { _values.insert(position, std::move(value)), true };
+    }
+
+    /**
+     * @brief Inserts a value constructed from @p args, unless an equivalent one is already present
+     *
+     * @param args Arguments the value is constructed from, followed by the allocator if it is allocator-aware
+     *
+     * @return Iterator to the equivalent value and whether the value was inserted
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return insert(std::make_obj_using_allocator<T>(get_allocator(), std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Inserts a range of values, sorting them once instead of inserting them one by one
+     *
+     * Values equivalent to one that is already present, or to an earlier one of the range, are dropped
+     *
+     * @param first Iterator to the first value
+     * @param last Iterator behind the last value
+     */
+    template <typename Iterator>
+    void insert(Iterator first, Iterator last) {
+        const auto old_size = static_cast<typename container_type::difference_type>(_values.size());
+        _values.insert(_values.end(), first, last);
+
+        std::stable_sort(_values.begin() + old_size, _values.end(), _compare);
+        std::inplace_merge(_values.begin(), _values.begin() + old_size, _values.end(), _compare);
+
+        const auto equivalent = [this](const T& lhs, const T& rhs) { return !_compare(lhs, rhs) && !_compare(rhs, lhs); };
+        _values.erase(std::unique(_values.begin(), _values.end(), equivalent), _values.end());
+    }
+
+    /**
+     * @brief Finds a value
+     *
+     * @param value Value to look up
+     *
+     * @return Iterator to the equivalent value, or `end()` if there is none
+     */
+    [[nodiscard]] const_iterator find(const T& value) const {
+        const auto it = lower_bound(value);
+        return it != _values.end() && !_compare(value, *it) ? it : _values.end();
+    }
+
+    /**
+     * @brief Checks whether an equivalent value is present
+     *
+     * @param value Value to look up
+     *
+     * @return True if there is an equivalent value
+     */
+    [[nodiscard]] bool contains(const T& value) const { return find(value) != _values.end(); }
+
+    /**
+     * @brief Returns the first value that is not ordered before @p value
+     *
+     * @param value Value to look up
+     *
+     * @return Iterator to the value, or `end()` if there is none
+     */
+    [[nodiscard]] const_iterator lower_bound(const T& value) const { return std::ranges::lower_bound(_values, value, _compare); }
+
+    /**
+     * @brief Returns the first value that is ordered after @p value
+     *
+     * @param value Value to look up
+     *
+     * @return Iterator to the value, or `end()` if there is none
+     */
+    [[nodiscard]] const_iterator upper_bound(const T& value) const { return std::ranges::upper_bound(_values, value, _compare); }
+
+    /**
+     * @brief Removes a value
+     *
+     * @param position Iterator to the value
+     *
+     * @return Iterator to the value behind the removed one
+     */
+    iterator erase(const_iterator position) { return _values.erase(position); }
+
+    /**
+     * @brief Removes every value that matches a predicate
+     *
+     * @param set Set to remove the values from
+     * @param predicate Predicate that is called with every value
+     *
+     * @return Number of removed values
+     */
+    template <typename Predicate>
+    friend size_type erase_if(FlatSet& set, Predicate predicate) {
+        return std::erase_if(set._values, predicate);
+    }
+
+    /**
+     * @brief Reserves memory for the given number of values
+     *
+     * @param capacity Number of values
+     */
+    void reserve(const size_type capacity) { _values.reserve(capacity); }
+
+    /**
+     * @brief Removes all values, but keeps the memory of the vector
+     */
+    void clear() { _values.clear(); }
+
+    [[nodiscard]] size_type size() const { return _values.size(); }
+    [[nodiscard]] size_type capacity() const { return _values.capacity(); }
+    [[nodiscard]] bool empty() const { return _values.empty(); }
+
+    [[nodiscard]] const_iterator begin() const { return _values.begin(); }
+    [[nodiscard]] const_iterator end() const { return _values.end(); }
+    [[nodiscard]] const_reverse_iterator rbegin() const { return _values.rbegin(); }
+    [[nodiscard]] const_reverse_iterator rend() const { return _values.rend(); }
+
+    /**
+     * @brief Returns the allocator of the values
+     *
+     * @return Allocator the set was created with
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return _values.get_allocator(); }
+
+private:
+    container_type _values;
+    [[no_unique_address]] Compare _compare;
+};
+} // namespace pretty_diagnostics
+
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
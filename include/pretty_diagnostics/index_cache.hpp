@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+#include "line_index.hpp"
+
+#ifndef _WIN32
+struct stat;
+#endif
+
+namespace pretty_diagnostics {
+/**
+ * @brief The size and modification time of a file, which identify the contents an index was built from
+ */
+struct FileStamp {
+    /**
+     * @brief Size of the file in bytes
+     */
+    uint64_t size = 0;
+
+    /**
+     * @brief Last modification time in nanoseconds since the Unix epoch
+     */
+    int64_t modified = 0;
+};
+
+/**
+ * @brief Returns the stamp of a file on disk
+ *
+ * Sources that read a file should take the stamp from the same `fstat()` that sized the read
+ * instead, otherwise a change in between pairs the old contents with the stamp of the new ones
+ *
+ * @param path Path to the file on disk (absolute or relative)
+ *
+ * @return The stamp, or `std::nullopt` if the file can't be inspected
+ */
+[[nodiscard]] std::optional<FileStamp> stamp_file(const std::filesystem::path& path);
+
+#ifndef _WIN32
+/**
+ * @brief Returns the stamp of a file from its status
+ *
+ * @param file_stat Status of the file, e.g. from the `fstat()` of the descriptor it is read from
+ *
+ * @return The stamp recorded in @p file_stat
+ */
+[[nodiscard]] FileStamp stamp_file(const struct ::stat& file_stat);
+#endif
+
+/**
+ * @brief Keeps the line indices of files on disk, so they don't have to be scanned again
+ *
+ * Every file gets its own entry in the cache directory, named after a hash of its canonical
+ * path. An entry records the size and modification time of the file it was built from and
+ * is only used while both still match, otherwise it is ignored and replaced on the next store.
+ *
+ * An entry consists of a fixed header followed by the path of the file, the line starts as
+ * 64-bit offsets and the ASCII flags of the rows as 64-bit words, each section 8-byte aligned
+ * and in the byte order of the machine that wrote it, so it can be read or mapped as a whole.
+ * Entries are written to a temporary file first and then renamed, so concurrent readers never
+ * see a partially written entry
+ */
+class IndexCache {
+public:
+    /**
+     * @brief Creates a cache that keeps its entries in the given directory
+     *
+     * @param directory Directory of the entries, created on the first store
+     */
+    explicit IndexCache(std::filesystem::path directory);
+
+    /**
+     * @brief Loads the cached line index data of a file
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     *
+     * @return The cached data, or `std::nullopt` if there is no entry or it is stale or corrupt
+     */
+    [[nodiscard]] std::optional<IndexData> load(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Loads the cached line index data of a file as it was when it was read
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     * @param stamp Stamp of the file taken when its contents were read
+     *
+     * @return The cached data, or `std::nullopt` if there is no entry or it is stale or corrupt
+     */
+    [[nodiscard]] std::optional<IndexData> load(const std::filesystem::path& path, const FileStamp& stamp) const;
+
+    /**
+     * @brief Stores the line index of a file, replacing an existing entry
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     * @param index Line index over the current contents of the file
+     *
+     * @return True if the entry was written, failing to write it is not an error
+     */
+    bool store(const std::filesystem::path& path, const LineIndex& index) const;
+
+    /**
+     * @brief Stores the line index of a file under the stamp of the contents it was built from
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     * @param index Line index over the contents of the file
+     * @param stamp Stamp of the file taken when its contents were read
+     *
+     * @return True if the entry was written, failing to write it is not an error
+     */
+    bool store(const std::filesystem::path& path, const LineIndex& index, const FileStamp& stamp) const;
+
+    /**
+     * @brief Returns the path of the entry that belongs to a file
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     *
+     * @return Path of the entry within the cache directory
+     */
+    [[nodiscard]] std::filesystem::path entry_path(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Returns the directory of the entries
+     *
+     * @return Directory given on construction
+     */
+    [[nodiscard]] const std::filesystem::path& directory() const { return _directory; }
+
+private:
+    std::filesystem::path _directory;
+};
+
+/**
+ * @brief Creates the line index of a file, restoring it from `IndexConfig::cache_directory` if possible
+ *
+ * @param contents Contents of the file, must outlive the index
+ * @param path Path to the file on disk (absolute or relative)
+ * @param stamp Stamp of the file taken when @p contents were read
+ * @param config Options that control how the index is built
+ *
+ * @return Index over @p contents, scanned as configured if the cache had no usable entry
+ */
+[[nodiscard]] LineIndex load_line_index(std::string_view contents, const std::filesystem::path& path, const FileStamp& stamp,
+                                        const IndexConfig& config);
+
+/**
+ * @brief Stores the line index of a file in `IndexConfig::cache_directory`
+ *
+ * Nothing is stored if the cache is disabled, the index was restored from it or it is lazy,
+ * since storing a lazy index would scan all of its contents
+ *
+ * @param path Path to the file on disk (absolute or relative)
+ * @param index Line index over the contents of the file
+ * @param stamp Stamp of the file taken when the indexed contents were read
+ * @param config Options the index was built with
+ */
+void store_line_index(const std::filesystem::path& path, const LineIndex& index, const FileStamp& stamp, const IndexConfig& config);
+} // namespace pretty_diagnostics
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
 #include "span.hpp"
 
 namespace pretty_diagnostics {
@@ -11,13 +15,38 @@ namespace pretty_diagnostics {
  */
 class Label {
 public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
     /**
      * @brief Constructs a label with a human-readable message and the span it refers to
      *
      * @param text Short message to display next to the span in the rendered output
      * @param span Source span this label highlights
+     * @param allocator Allocator of the text
+     */
+    Label(std::string_view text, Span span, const allocator_type& allocator = {});
+
+    Label(const Label& other) = default;
+    Label(Label&& other) noexcept = default;
+
+    /**
+     * @brief Copies a label into the memory of another allocator
+     *
+     * @param other Label to copy
+     * @param allocator Allocator of the copied text
+     */
+    Label(const Label& other, const allocator_type& allocator);
+
+    /**
+     * @brief Moves a label into the memory of another allocator
+     *
+     * @param other Label to move
+     * @param allocator Allocator of the moved text
      */
-    Label(std::string text, Span span);
+    Label(Label&& other, const allocator_type& allocator);
+
+    Label& operator=(const Label& other) = default;
+    Label& operator=(Label&& other) noexcept = default;
 
     /**
      * @brief Orders labels by their span to allow placement within a line/group
@@ -64,7 +93,7 @@ public:
      *
      * @return Human-readable message associated with this label
      */
-    [[nodiscard]] const std::string& text() const { return _text; }
+    [[nodiscard]] std::string_view text() const { return _text; }
 
     /**
      * @brief Returns the span associated with this label
@@ -73,8 +102,15 @@ public:
      */
     [[nodiscard]] const Span& span() const { return _span; }
 
+    /**
+     * @brief Returns the allocator of the label text
+     *
+     * @return Allocator the label was created with
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return _text.get_allocator(); }
+
 private:
-    std::string _text;
+    std::pmr::string _text;
     Span _span;
 };
 } // namespace pretty_diagnostics
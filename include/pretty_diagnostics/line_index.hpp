@@ -0,0 +1,535 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "unicode.hpp"
+
+namespace pretty_diagnostics {
+/**
+ * @brief Implementations of the newline scanning kernel
+ */
+enum class ScanKernel {
+    Auto,     ///< The fastest kernel supported by the running CPU
+    Portable, ///< A `memchr` based kernel that works everywhere
+    SSE2,     ///< Scans 16 bytes at a time, x86 only
+    AVX2,     ///< Scans 32 bytes at a time, x86 only
+};
+
+/**
+ * @brief Checks whether the given kernel can be used on the running CPU
+ *
+ * @param kernel Kernel to check
+ *
+ * @return True if @p kernel is compiled in and supported by the CPU
+ */
+[[nodiscard]] bool is_kernel_supported(ScanKernel kernel);
+
+/**
+ * @brief Counts the line feed characters in the input
+ *
+ * @param input Text to scan
+ * @param kernel Kernel used for scanning
+ *
+ * @return Number of `\n` characters in @p input
+ * @throws std::runtime_error If @p kernel is not supported
+ */
+[[nodiscard]] size_t count_newlines(std::string_view input, ScanKernel kernel = ScanKernel::Auto);
+
+/**
+ * @brief Appends the start offsets of all lines following a line feed in the input
+ *
+ * The vector is grown exactly once, sized by a counting pass over the input
+ *
+ * @param input Text to scan
+ * @param offset Offset that is added to every line start, i.e. the position of @p input in the whole text
+ * @param line_starts Vector the line starts are appended to
+ * @param kernel Kernel used for scanning
+ *
+ * @throws std::runtime_error If @p kernel is not supported
+ */
+void find_line_starts(std::string_view input, size_t offset, std::vector<size_t>& line_starts, ScanKernel kernel = ScanKernel::Auto);
+
+/**
+ * @brief Controls when the line index scans the contents for line breaks
+ */
+enum class IndexMode {
+    Eager, ///< The whole contents are scanned on construction
+    Lazy,  ///< The contents are scanned on demand, only as far as rows or offsets were requested
+};
+
+/**
+ * @brief Controls how the line index stores the start offsets of the lines
+ */
+enum class IndexEncoding {
+    Auto,    ///< Narrow if the contents fit into 32-bit offsets, otherwise Wide
+    Wide,    ///< A 64-bit offset per line
+    Narrow,  ///< A 32-bit offset per line, only for contents smaller than 4 GiB
+    Compact, ///< Variable-length deltas between lines, with an absolute offset sampled every 64 lines
+};
+
+/**
+ * @brief Configuration options for building a `LineIndex`
+ */
+struct IndexConfig {
+    /**
+     * @brief When the contents are scanned for line breaks
+     *
+     * Defaults to an eager scan on construction
+     */
+    IndexMode mode = IndexMode::Eager;
+
+    /**
+     * @brief Number of worker threads used to scan large contents
+     *
+     * A value of 0 uses the hardware concurrency, 1 always scans on the calling thread
+     */
+    size_t threads = 0;
+
+    /**
+     * @brief Scans of fewer bytes than this always run on the calling thread
+     *
+     * Defaults to 32 MiB, below that the cost of starting workers outweighs the gain
+     */
+    size_t parallel_threshold = 32 * 1024 * 1024;
+
+    /**
+     * @brief How the line starts are stored
+     *
+     * Defaults to the smallest encoding that keeps lookups as fast as with 64-bit offsets
+     */
+    IndexEncoding encoding = IndexEncoding::Auto;
+
+    /**
+     * @brief Directory in which the line indices of file sources are cached between runs
+     *
+     * Defaults to an empty path, which disables the cache. See `IndexCache`
+     */
+    std::filesystem::path cache_directory = {};
+};
+
+/**
+ * @brief The scan results of a `LineIndex`, e.g. to keep them between runs
+ */
+struct IndexData {
+    /**
+     * @brief Start offset of every row in ascending order, beginning with 0
+     */
+    std::vector<size_t> line_starts;
+
+    /**
+     * @brief Whether a row contains bytes outside of ASCII, one flag per row
+     */
+    std::vector<bool> non_ascii;
+};
+
+/**
+ * @brief An append-only, ascending sequence of line start offsets
+ *
+ * Depending on the encoding an offset takes 8, 4 or, for the compact encoding, usually
+ * a single byte. The compact encoding stores the distance to the previous line start as
+ * a variable-length integer and samples the absolute offset of every 64th line, so random
+ * access decodes at most one block and searching stays O(log n).
+ */
+class LineStartTable {
+public:
+    /**
+     * @brief Creates an empty table
+     *
+     * @param encoding Encoding of the offsets, must not be `IndexEncoding::Auto`
+     */
+    explicit LineStartTable(IndexEncoding encoding);
+
+    /**
+     * @brief Appends line starts to the table
+     *
+     * @param line_starts Ascending offsets, none smaller than the last one in the table
+     *
+     * @throws std::runtime_error If an offset can't be represented by the encoding
+     */
+    void append(std::span<const size_t> line_starts);
+
+    /**
+     * @brief Returns the offset at the given position
+     *
+     * @param position 0-based position, must be smaller than `size()`
+     *
+     * @return The line start at @p position
+     */
+    [[nodiscard]] size_t operator[](size_t position) const;
+
+    /**
+     * @brief Returns the position of the last line start not greater than the given offset
+     *
+     * @param offset Byte offset to look up, must not be smaller than the first line start
+     *
+     * @return 0-based position into the table
+     */
+    [[nodiscard]] size_t find(size_t offset) const;
+
+    /**
+     * @brief Releases capacity that was reserved for further line starts
+     */
+    void shrink_to_fit();
+
+    /**
+     * @brief Returns the heap memory held by the table
+     *
+     * @return Allocated bytes, including unused capacity
+     */
+    [[nodiscard]] size_t memory_usage() const;
+
+    /**
+     * @brief Returns the uncompressed storage that line starts can be written to in place
+     *
+     * @return The storage of the wide encoding, otherwise `nullptr`
+     */
+    [[nodiscard]] std::vector<size_t>* wide_storage() { return _encoding == IndexEncoding::Wide ? &_wide : nullptr; }
+
+    /**
+     * @brief Returns the encoding of the offsets
+     *
+     * @return The encoding the table was created with
+     */
+    [[nodiscard]] IndexEncoding encoding() const { return _encoding; }
+
+    /**
+     * @brief Returns the number of line starts in the table
+     *
+     * @return Number of stored offsets
+     */
+    [[nodiscard]] size_t size() const;
+
+private:
+    [[nodiscard]] size_t _compact_find(size_t offset) const;
+
+    [[nodiscard]] size_t _compact_at(size_t position) const;
+
+private:
+    std::vector<size_t> _wide;
+    std::vector<uint32_t> _narrow;
+    std::vector<size_t> _samples, _block_offsets;
+    std::vector<uint8_t> _deltas;
+    size_t _compact_size, _last;
+    IndexEncoding _encoding;
+};
+
+/**
+ * @brief Maps byte offsets of a text buffer to rows and back
+ *
+ * The index stores the byte offset at which every line starts. It does not own
+ * the text it indexes, the referenced buffer has to outlive the index and must not
+ * be modified or moved while the index is in use.
+ *
+ * In lazy mode the line starts are discovered incrementally, so construction is O(1)
+ * and the scanning cost is proportional to the highest offset or row requested so far.
+ * Large scans are split into chunks that are scanned by a set of worker threads.
+ *
+ * The line starts can be stored in a compact encoding, see `IndexEncoding`.
+ *
+ * Next to the line starts, the index records which lines are pure ASCII. On those lines
+ * byte and visual columns are the same, every other line gets a lazily built table of
+ * checkpoints, so converting between both kinds of columns never decodes the whole line.
+ * All queries are safe to be called concurrently
+ */
+class LineIndex {
+public:
+    /**
+     * @brief Creates the line index for the given contents
+     *
+     * @param contents Text buffer to index, must outlive the index
+     * @param config Options that control how the index is built
+     */
+    explicit LineIndex(std::string_view contents, const IndexConfig& config = {});
+
+    /**
+     * @brief Creates the line index for the given contents from previously collected data
+     *
+     * The data is checked against the contents first, if it doesn't fit them it is discarded
+     * and the contents are scanned as configured
+     *
+     * @param contents Text buffer to index, must outlive the index
+     * @param data Scan results of an earlier index over the same contents
+     * @param config Options that control how the index is built
+     */
+    LineIndex(std::string_view contents, IndexData data, const IndexConfig& config = {});
+
+    /**
+     * @brief Copies the index, it keeps referring to the same text buffer as @p other
+     *
+     * @param other Index to copy, may be used concurrently while it is copied
+     */
+    LineIndex(const LineIndex& other);
+
+    /**
+     * @brief Moves the index, it keeps referring to the same text buffer as @p other
+     *
+     * @param other Index to move from, must not be in use
+     */
+    LineIndex(LineIndex&& other) noexcept;
+
+    /**
+     * @brief Replaces the index with a copy of another one
+     *
+     * @param other Index to copy, may be used concurrently while it is copied
+     *
+     * @return Reference to this index
+     */
+    LineIndex& operator=(const LineIndex& other);
+
+    /**
+     * @brief Replaces the index with another one
+     *
+     * @param other Index to move from, must not be in use
+     *
+     * @return Reference to this index
+     */
+    LineIndex& operator=(LineIndex&& other) noexcept;
+
+    /**
+     * @brief Makes the index refer to another buffer with the same contents
+     *
+     * Used by owners of the indexed text after they were copied or moved, so the index
+     * points into their own buffer again
+     *
+     * @param contents Copy of the indexed text, must outlive the index
+     *
+     * @throws std::runtime_error If @p contents differ in size from the indexed text
+     */
+    void rebind(std::string_view contents);
+
+    /**
+     * @brief Returns the 0-based row that contains the given byte offset
+     *
+     * @param index 0-based byte offset, may be equal to the size of the contents
+     *
+     * @return 0-based row containing @p index
+     */
+    [[nodiscard]] size_t row(size_t index) const;
+
+    /**
+     * @brief Returns the byte offset at which the given row starts
+     *
+     * @param row 0-based row
+     *
+     * @return Byte offset of the first character of @p row
+     */
+    [[nodiscard]] size_t line_start(size_t row) const;
+
+    /**
+     * @brief Returns the contents of the given row
+     *
+     * @param row 0-based row
+     *
+     * @return View of the row without its trailing line break
+     */
+    [[nodiscard]] std::string_view line(size_t row) const;
+
+    /**
+     * @brief Checks whether the given row only contains ASCII characters
+     *
+     * @param row 0-based row
+     *
+     * @return True if every byte of @p row is ASCII
+     */
+    [[nodiscard]] bool is_ascii(size_t row) const;
+
+    /**
+     * @brief Returns the visual column of a byte column in the given row
+     *
+     * Equivalent to `pretty_diagnostics::to_visual_column()` on the row, but O(1) for ASCII
+     * rows and O(log n) for all others
+     *
+     * @param row 0-based row
+     * @param byte_column 0-based byte column into @p row
+     *
+     * @return 0-based visual column
+     */
+    [[nodiscard]] size_t to_visual_column(size_t row, size_t byte_column) const;
+
+    /**
+     * @brief Returns the byte column of a visual column in the given row
+     *
+     * Equivalent to `pretty_diagnostics::from_visual_column()` on the row, but O(1) for ASCII
+     * rows and O(log n) for all others
+     *
+     * @param row 0-based row
+     * @param visual_column 0-based visual column into @p row
+     *
+     * @return 0-based byte column
+     */
+    [[nodiscard]] size_t from_visual_column(size_t row, size_t visual_column) const;
+
+    /**
+     * @brief Returns the column of a byte column in the given row and unit
+     *
+     * Equivalent to `pretty_diagnostics::to_column()` on the row, but O(1) for ASCII rows
+     * and O(log n) for all others
+     *
+     * @param row 0-based row
+     * @param byte_column 0-based byte column into @p row
+     * @param unit Unit of the returned column
+     *
+     * @return 0-based column in @p unit
+     */
+    [[nodiscard]] size_t to_column(size_t row, size_t byte_column, ColumnUnit unit) const;
+
+    /**
+     * @brief Returns the byte column of a column in the given row and unit
+     *
+     * Equivalent to `pretty_diagnostics::from_column()` on the row, but O(1) for ASCII rows
+     * and O(log n) for all others
+     *
+     * @param row 0-based row
+     * @param column 0-based column in @p unit
+     * @param unit Unit of @p column
+     *
+     * @return 0-based byte column
+     */
+    [[nodiscard]] size_t from_column(size_t row, size_t column, ColumnUnit unit) const;
+
+    /**
+     * @brief Converts a column in the given row from one unit into another
+     *
+     * @param row 0-based row
+     * @param column 0-based column in @p from
+     * @param from Unit of @p column
+     * @param to Unit of the returned column
+     *
+     * @return 0-based column in @p to
+     */
+    [[nodiscard]] size_t convert_column(size_t row, size_t column, ColumnUnit from, ColumnUnit to) const;
+
+    /**
+     * @brief Checks whether the given row exists, scanning only as far as necessary
+     *
+     * @param row 0-based row
+     *
+     * @return True if the contents have more than @p row rows
+     */
+    [[nodiscard]] bool contains_row(size_t row) const;
+
+    /**
+     * @brief Returns the total number of rows
+     *
+     * In lazy mode this forces the remaining contents to be scanned
+     *
+     * @return Row count, at least one even for empty contents
+     */
+    [[nodiscard]] size_t line_count() const;
+
+    /**
+     * @brief Returns the heap memory held by the index
+     *
+     * Covers the line starts, the ASCII flags of the rows and all column tables built so far
+     *
+     * @return Allocated bytes, including unused capacity
+     */
+    [[nodiscard]] size_t memory_usage() const;
+
+    /**
+     * @brief Returns the scan results of the index
+     *
+     * In lazy mode this forces the remaining contents to be scanned
+     *
+     * @return Copy of the line starts and ASCII flags of all rows
+     */
+    [[nodiscard]] IndexData data() const;
+
+    /**
+     * @brief Checks whether the index was created from previously collected data
+     *
+     * @return True if the data given on construction was used instead of scanning the contents
+     */
+    [[nodiscard]] bool is_restored() const { return _restored; }
+
+    /**
+     * @brief Returns the encoding the line starts are stored in
+     *
+     * @return The encoding that was chosen on construction, never `IndexEncoding::Auto`
+     */
+    [[nodiscard]] IndexEncoding encoding() const { return _line_starts.encoding(); }
+
+    /**
+     * @brief Returns the indexed contents
+     *
+     * @return View of the indexed text buffer
+     */
+    [[nodiscard]] std::string_view contents() const { return _contents; }
+
+private:
+    /**
+     * @brief A character boundary within a row with the column it starts at in every unit
+     */
+    struct ColumnCheckpoint {
+        std::array<size_t, 4> columns; // Indexed by `ColumnUnit`
+
+        [[nodiscard]] size_t operator[](const ColumnUnit unit) const { return columns[static_cast<size_t>(unit)]; }
+    };
+
+    using ColumnTable = std::vector<ColumnCheckpoint>;
+
+    [[nodiscard]] const ColumnTable* _column_table(size_t row, std::string_view line) const;
+
+    void _mark_non_ascii(size_t start, size_t end) const;
+
+    void _scan_to_offset(size_t offset) const;
+
+    void _scan_to_row(size_t row) const;
+
+    void _scan(size_t end) const;
+
+    [[nodiscard]] std::shared_lock<std::shared_mutex> _read_lock() const;
+
+    [[nodiscard]] bool _fits(const IndexData& data) const;
+
+private:
+    mutable std::unordered_map<size_t, ColumnTable> _column_tables;
+    mutable std::shared_mutex _column_mutex;
+
+    mutable LineStartTable _line_starts;
+    mutable std::vector<bool> _non_ascii;
+    mutable std::shared_mutex _mutex;
+    size_t _threads, _parallel_threshold;
+    mutable std::atomic<bool> _complete;
+    mutable size_t _scanned;
+    std::string_view _contents;
+    bool _restored;
+};
+} // namespace pretty_diagnostics
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
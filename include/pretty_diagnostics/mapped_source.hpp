@@ -0,0 +1,277 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "index_cache.hpp"
+#include "line_index.hpp"
+#include "source.hpp"
+
+namespace pretty_diagnostics {
+/**
+ * @brief Access pattern hints that are forwarded to the operating system for mapped memory
+ */
+enum class AccessHint {
+    Normal,     ///< No special treatment
+    Sequential, ///< Pages will be accessed in sequential order, aggressive read-ahead
+    Random,     ///< Pages will be accessed in random order, read-ahead is not useful
+    WillNeed,   ///< Pages will be accessed soon and should be paged in ahead of time
+    DontNeed,   ///< Pages will not be accessed soon and may be released
+};
+
+/**
+ * @brief A `Source` implementation that maps a file on disk into memory
+ *
+ * Opening the source costs a single open, stat and map of the file, the contents are
+ * never copied into the heap. Substrings and lines are served straight from the mapping,
+ * which stays alive for the whole lifetime of the source
+ */
+class MappedFileSource final : public Source {
+public:
+    /**
+     * @brief Maps a file from a filesystem path
+     *
+     * The line index is cached like the one of a `FileSource`, see `IndexConfig::cache_directory`
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     * @param working_path Optional path to make the path relative
+     * @param hint Access pattern hint that is applied to the whole mapping
+     * @param config Options that control how the line index is built
+     */
+    explicit MappedFileSource(const std::filesystem::path& path, const std::filesystem::path& working_path = std::filesystem::current_path(),
+                              AccessHint hint = AccessHint::Normal, const IndexConfig& config = {});
+
+    MappedFileSource(const MappedFileSource&) = delete;
+    MappedFileSource& operator=(const MappedFileSource&) = delete;
+
+    /**
+     * @brief Applies an access pattern hint to the whole mapping
+     *
+     * @param hint Access pattern hint
+     */
+    void advise(AccessHint hint) const;
+
+    /**
+     * @brief Applies an access pattern hint to the pages covering the given range
+     *
+     * @param hint Access pattern hint
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     */
+    void advise(AccessHint hint, const Location& start, const Location& end) const;
+
+    /**
+     * @brief Maps (row, column) to a `Location` within the file
+     *
+     * @param row 0-based line number
+     * @param column 0-based column number
+     *
+     * @return Location corresponding to the given coordinates
+     */
+    [[nodiscard]] Location from_coords(size_t row, size_t column) const override;
+
+    /**
+     * @brief Maps an absolute index to a `Location` within the file
+     *
+     * @param index 0-based absolute character index
+     *
+     * @return Location corresponding to the given index
+     */
+    [[nodiscard]] Location from_index(size_t index) const override;
+
+    /**
+     * @brief Extracts a substring delimited by two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return Substring between @p start and @p end
+     */
+    [[nodiscard]] std::string substr(const Location& start, const Location& end) const override;
+
+    /**
+     * @brief Returns a view into the mapping between two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return View of the text between @p start and @p end
+     */
+    [[nodiscard]] std::string_view substr_view(const Location& start, const Location& end) const override;
+
+    /**
+     * @brief Returns the contents of the line containing the given location
+     *
+     * @param location A location within the desired line
+     *
+     * @return The entire line contents without a trailing newline
+     */
+    [[nodiscard]] std::string line(const Location& location) const override;
+
+    /**
+     * @brief Returns the contents of the specified line number
+     *
+     * @param line_number 0-based line number
+     *
+     * @return The entire line contents without a trailing newline
+     */
+    [[nodiscard]] std::string line(size_t line_number) const override;
+
+    /**
+     * @brief Returns a view into the mapping of the line containing the given location
+     *
+     * @param location A location within the desired line
+     *
+     * @return View of the line without a trailing newline
+     */
+    [[nodiscard]] std::string_view line_view(const Location& location) const override;
+
+    /**
+     * @brief Returns a view into the mapping of the specified line number
+     *
+     * @param line_number 0-based line number
+     *
+     * @return View of the line without a trailing newline
+     */
+    [[nodiscard]] std::string_view line_view(size_t line_number) const override;
+
+    /**
+     * @brief Returns the total number of lines in the file
+     *
+     * @return Line count
+     */
+    [[nodiscard]] size_t line_count() const override;
+
+    /**
+     * @brief Checks whether the file has the given line, scanning only as far as necessary
+     *
+     * @param line_number 0-based line number
+     *
+     * @return True if @p line_number is smaller than the line count
+     */
+    [[nodiscard]] bool has_line(size_t line_number) const override;
+
+    /**
+     * @brief Returns the absolute index at which the given line starts
+     *
+     * @param line_number 0-based line number
+     *
+     * @return 0-based index of the first character of the line
+     */
+    [[nodiscard]] size_t line_start(size_t line_number) const override;
+
+    /**
+     * @brief Converts a column in the given line from one unit into another
+     *
+     * @param line_number 0-based line number
+     * @param column 0-based column in @p from
+     * @param from Unit of @p column
+     * @param to Unit of the returned column
+     *
+     * @return 0-based column in @p to
+     */
+    [[nodiscard]] size_t convert_column(size_t line_number, size_t column, ColumnUnit from, ColumnUnit to) const override;
+
+    /**
+     * @brief Returns the entire contents of the file as a string
+     *
+     * The mapping is copied into a string on the first call, prefer `contents_view()`
+     * to access the contents without copying them
+     *
+     * @return Full file contents
+     */
+    [[nodiscard]] const std::string& contents() const override;
+
+    /**
+     * @brief Returns the entire contents of the file without copying them
+     *
+     * @return View into the mapping, valid for the lifetime of the source
+     */
+    [[nodiscard]] std::string_view contents_view() const override;
+
+    /**
+     * @brief Returns a displayable path or identifier of the source
+     *
+     * @return Display path or identifier
+     */
+    [[nodiscard]] std::string path() const override;
+
+    /**
+     * @brief Returns the total size (in characters) of the file
+     *
+     * @return Size in characters
+     */
+    [[nodiscard]] size_t size() const override;
+
+    /**
+     * @brief Returns the line index of the file
+     *
+     * @return Index used to resolve rows and columns, e.g. to inspect its memory usage
+     */
+    [[nodiscard]] const LineIndex& line_index() const { return _index; }
+
+private:
+    /**
+     * @brief Owns a read-only mapping of a whole file and releases it on destruction
+     */
+    struct Mapping {
+        explicit Mapping(const std::filesystem::path& path);
+        ~Mapping();
+
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(const Mapping&) = delete;
+
+        const char* data = nullptr;
+        size_t size = 0;
+        FileStamp stamp = {};
+    };
+
+    std::string _display_path;
+    Mapping _mapping;
+    LineIndex _index;
+
+    mutable std::once_flag _contents_flag;
+    mutable std::string _contents;
+};
+} // namespace pretty_diagnostics
+
+/**
+ * @brief Streams a readable description of a `MappedFileSource`
+ *
+ * @param os Output stream to write to
+ * @param source Source to describe
+ *
+ * @return Reference to @p os.
+ */
+std::ostream& operator<<(std::ostream& os, const pretty_diagnostics::MappedFileSource& source);
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <filesystem>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace pretty_diagnostics {
+/**
+ * @brief Turns file paths into display paths relative to a working directory and remembers them
+ *
+ * `std::filesystem::relative()` canonicalizes both of its arguments, which stats every
+ * component of the paths for each file that is opened. The resolver canonicalizes the working
+ * directory once and computes the display paths lexically from there, so resolving a path
+ * doesn't touch the filesystem at all. Already resolved paths are looked up in a cache,
+ * which is why a single resolver should be shared by every source of a run.
+ *
+ * Since nothing is canonicalized besides the working directory, paths that reach a file
+ * through a symbolic link keep the link in their display path. Relative paths are resolved
+ * against the current directory at the time the resolver was created. All members are safe
+ * to be called concurrently
+ */
+class PathResolver {
+public:
+    /**
+     * @brief Creates a resolver for display paths relative to the given directory
+     *
+     * @param working_path Directory that the display paths are made relative to
+     */
+    explicit PathResolver(const std::filesystem::path& working_path = std::filesystem::current_path());
+
+    PathResolver(const PathResolver&) = delete;
+    PathResolver& operator=(const PathResolver&) = delete;
+
+    /**
+     * @brief Returns the display path of a file
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     *
+     * @return Path relative to the working directory, or the normalized absolute path if there is none
+     */
+    [[nodiscard]] std::string display_path(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Returns the canonical working directory
+     *
+     * @return Directory that the display paths are made relative to
+     */
+    [[nodiscard]] const std::filesystem::path& working_path() const { return _working_path; }
+
+    /**
+     * @brief Returns the number of paths that were resolved so far
+     *
+     * @return Number of cached display paths
+     */
+    [[nodiscard]] size_t size() const;
+
+private:
+    std::filesystem::path _working_path;
+    std::filesystem::path _current_path;
+
+    mutable std::unordered_map<std::string, std::string> _display_paths;
+    mutable std::shared_mutex _mutex;
+};
+} // namespace pretty_diagnostics
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
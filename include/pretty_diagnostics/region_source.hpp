@@ -0,0 +1,305 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "source.hpp"
+#include "span.hpp"
+
+namespace pretty_diagnostics {
+/**
+ * @brief A `Source` implementation that views a byte range of another source
+ *
+ * Regions are meant for code that is embedded in a larger document, e.g. SQL inside a raw
+ * string literal or a template block of an HTML file. The region doesn't copy the text of
+ * its parent and doesn't scan it for lines either, its rows are the rows of the parent
+ * from the one the region starts in, and only the first row is shifted by the columns
+ * in front of the region. Locations of the region and its parent are translated into each
+ * other, so diagnostics can be rendered against either of them.
+ *
+ * Views returned by this source are views of the parent and share their lifetime. The
+ * parent has to outlive the region and must not be edited while the region is alive
+ */
+class RegionSource final : public Source {
+public:
+    /**
+     * @brief Creates a region over a byte range of a parent source
+     *
+     * @param parent Source the region is taken from
+     * @param start_index 0-based start index within @p parent (inclusive)
+     * @param end_index 0-based end index within @p parent (exclusive)
+     * @param display_path Display path used in diagnostics, the path of @p parent if empty
+     *
+     * @throws std::runtime_error If @p parent is null or the range is invalid
+     */
+    RegionSource(std::shared_ptr<Source> parent, size_t start_index, size_t end_index, std::string display_path = {});
+
+    RegionSource(const RegionSource&) = delete;
+    RegionSource& operator=(const RegionSource&) = delete;
+
+    /**
+     * @brief Translates a location of the region into its parent
+     *
+     * @param location Location within this region
+     *
+     * @return Location of the same character within the parent
+     * @throws std::runtime_error If @p location is outside of the region
+     */
+    [[nodiscard]] Location to_parent(const Location& location) const;
+
+    /**
+     * @brief Translates a location of the parent into the region
+     *
+     * @param location Location within the parent
+     *
+     * @return Location of the same character within this region
+     * @throws std::runtime_error If @p location is outside of the region
+     */
+    [[nodiscard]] Location from_parent(const Location& location) const;
+
+    /**
+     * @brief Checks whether a location of the parent lies within the region
+     *
+     * @param location Location within the parent
+     *
+     * @return True if @p location is between the start and end of the region, both inclusive
+     */
+    [[nodiscard]] bool contains(const Location& location) const;
+
+    /**
+     * @brief Returns a location corresponding to the given row and column
+     *
+     * @param row 0-based line number
+     * @param column 0-based column number
+     *
+     * @return Mapped location
+     */
+    [[nodiscard]] Location from_coords(size_t row, size_t column) const override;
+
+    /**
+     * @brief Returns a location for the given absolute character index
+     *
+     * @param index 0-based absolute character index
+     *
+     * @return Mapped location
+     */
+    [[nodiscard]] Location from_index(size_t index) const override;
+
+    /**
+     * @brief Returns the substring between two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return Substring between @p start and @p end
+     */
+    [[nodiscard]] std::string substr(const Location& start, const Location& end) const override;
+
+    /**
+     * @brief Returns a view of the text between two locations without copying it
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return View into the parent
+     */
+    [[nodiscard]] std::string_view substr_view(const Location& start, const Location& end) const override;
+
+    /**
+     * @brief Returns the full line at the given location
+     *
+     * @param location A location within the desired line
+     *
+     * @return The part of the line within the region, without a trailing newline
+     */
+    [[nodiscard]] std::string line(const Location& location) const override;
+
+    /**
+     * @brief Returns the contents of the specified line number
+     *
+     * @param line_number 0-based line number
+     *
+     * @return The part of the line within the region, without a trailing newline
+     */
+    [[nodiscard]] std::string line(size_t line_number) const override;
+
+    /**
+     * @brief Returns a view of the full line at the given location without copying it
+     *
+     * @param location A location within the desired line
+     *
+     * @return View into the parent of the part of the line within the region
+     */
+    [[nodiscard]] std::string_view line_view(const Location& location) const override;
+
+    /**
+     * @brief Returns a view of the specified line number without copying it
+     *
+     * @param line_number 0-based line number
+     *
+     * @return View into the parent of the part of the line within the region
+     */
+    [[nodiscard]] std::string_view line_view(size_t line_number) const override;
+
+    /**
+     * @brief Returns the total number of lines in the region
+     *
+     * @return Line count
+     */
+    [[nodiscard]] size_t line_count() const override;
+
+    /**
+     * @brief Returns the absolute index at which the given line starts
+     *
+     * @param line_number 0-based line number
+     *
+     * @return 0-based index of the first character of the line
+     */
+    [[nodiscard]] size_t line_start(size_t line_number) const override;
+
+    /**
+     * @brief Converts a column in the given line from one unit into another
+     *
+     * @param line_number 0-based line number
+     * @param column 0-based column in @p from
+     * @param from Unit of @p column
+     * @param to Unit of the returned column
+     *
+     * @return 0-based column in @p to
+     */
+    [[nodiscard]] size_t convert_column(size_t line_number, size_t column, ColumnUnit from, ColumnUnit to) const override;
+
+    /**
+     * @brief Returns the entire contents of the region
+     *
+     * Copies the region on the first call, prefer `contents_view()` to access the contents
+     * without copying them
+     *
+     * @return Full region contents
+     */
+    [[nodiscard]] const std::string& contents() const override;
+
+    /**
+     * @brief Returns a view of the entire contents without copying them
+     *
+     * @return View into the parent
+     */
+    [[nodiscard]] std::string_view contents_view() const override;
+
+    /**
+     * @brief Pins the parent, whose views are the views of the region
+     *
+     * @return Handle of the parent's pin
+     */
+    [[nodiscard]] std::shared_ptr<const void> pin() const override;
+
+    /**
+     * @brief Returns a displayable path or identifier of the source
+     *
+     * @return Display path or identifier
+     */
+    [[nodiscard]] std::string path() const override;
+
+    /**
+     * @brief Returns the total size (in characters) of the region
+     *
+     * @return Size in characters
+     */
+    [[nodiscard]] size_t size() const override;
+
+    /**
+     * @brief Returns the source the region is taken from
+     *
+     * @return Parent source
+     */
+    [[nodiscard]] const std::shared_ptr<Source>& parent() const { return _parent; }
+
+    /**
+     * @brief Returns the location within the parent at which the region starts
+     *
+     * @return Inclusive start location within the parent
+     */
+    [[nodiscard]] const Location& start() const { return _start; }
+
+    /**
+     * @brief Returns the location within the parent at which the region ends
+     *
+     * @return Exclusive end location within the parent
+     */
+    [[nodiscard]] const Location& end() const { return _end; }
+
+private:
+    [[nodiscard]] size_t _line_offset(size_t line_number) const;
+
+private:
+    std::shared_ptr<Source> _parent;
+    Location _start, _end;
+    std::string _display_path;
+
+    mutable std::once_flag _contents_flag;
+    mutable std::string _contents;
+};
+
+/**
+ * @brief Translates a span of a region into the parent of the region
+ *
+ * @param span Span whose source is a `RegionSource`
+ *
+ * @return Span over the same text within the parent
+ * @throws std::runtime_error If the source of @p span is not a region
+ */
+[[nodiscard]] Span to_parent(const Span& span);
+
+/**
+ * @brief Translates a span of a parent source into one of its regions
+ *
+ * @param region Region to translate the span into
+ * @param span Span whose source is the parent of @p region
+ *
+ * @return Span over the same text within @p region
+ * @throws std::runtime_error If @p span belongs to another source or lies outside of @p region
+ */
+[[nodiscard]] Span to_region(const std::shared_ptr<RegionSource>& region, const Span& span);
+} // namespace pretty_diagnostics
+
+/**
+ * @brief Streams a readable description of a `RegionSource`
+ *
+ * @param os Output stream to write to
+ * @param source Source to describe
+ *
+ * @return Reference to @p os.
+ */
+std::ostream& operator<<(std::ostream& os, const pretty_diagnostics::RegionSource& source);
+
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
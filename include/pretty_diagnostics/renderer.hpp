@@ -1,6 +1,8 @@
 #pragma once
 
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "report.hpp"
@@ -60,6 +62,14 @@ struct Config {
      * Defaults to the Unicode glyph set.
      */
     GlyphSet glyphs = Glyphs::Unicode();
+
+    /**
+     * @brief Whether labels in expanded code are followed by the locations they were expanded from
+     *
+     * Every layer of expansion is rendered as an additional file group with an
+     * "expanded from here" label. Defaults to true.
+     */
+    bool show_expansions = true;
 };
 
 /**
@@ -135,6 +145,19 @@ public:
      */
     [[nodiscard]] static size_t widest_line_number(const Report::MappedFileGroups& groups, size_t padding);
 
+    /**
+     * @brief Collects the locations that the labels of a report were expanded from
+     *
+     * Follows the span of every label within an `ExpansionSource` through all layers of
+     * expansion and groups the resulting spans by their source. Spans that overlap an
+     * already collected one are dropped, multi-row spans are cut at the end of their first row
+     *
+     * @param report Report whose labels are followed
+     *
+     * @return File groups ordered by the depth of their first span within the expansion chains
+     */
+    [[nodiscard]] static std::vector<FileGroup> expansion_groups(const Report& report);
+
     /**
      * @brief Wraps the given text to lines no longer than `max_width` characters
      *
@@ -143,7 +166,7 @@ public:
      *
      * @return Wrapped text as a vector of lines
      */
-    [[nodiscard]] static std::vector<std::string> wrap_text(const std::string& text, size_t max_width);
+    [[nodiscard]] static std::vector<std::string> wrap_text(std::string_view text, size_t max_width);
 
     /**
      * @brief Prints the wrapped text into lines no longer than `max_width` characters and adds a prefix to
@@ -154,10 +177,13 @@ public:
      * @param max_width Maximum line width
      * @param stream  Output stream to write to
      */
-    static void print_wrapped_text(const std::string& text, const std::string& wrapped_prefix, size_t max_width, std::ostream& stream);
+    static void print_wrapped_text(std::string_view text, const std::string& wrapped_prefix, size_t max_width, std::ostream& stream);
+
+private:
+    void _fit_line_numbers(std::span<const FileGroup> expansions);
 
 private:
-    size_t _line_number_width, _snippet_width;
+    size_t _min_line_number_width, _line_number_width, _snippet_width;
     std::string _whitespaces;
     Config _config;
 };
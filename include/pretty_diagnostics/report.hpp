@@ -1,12 +1,15 @@
 #pragma once
 
 #include <iostream>
-#include <map>
+#include <memory_resource>
 #include <optional>
-#include <set>
+#include <ranges>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
+#include "flat_map.hpp"
 #include "label.hpp"
 
 namespace pretty_diagnostics {
@@ -24,16 +27,54 @@ enum class Severity {
 
 /**
  * @brief A set of labels that belong to the same 0-based line number
+ *
+ * The labels are kept sorted in one contiguous vector, so rendering walks them without
+ * chasing tree nodes. The group and its labels allocate from the memory resource of its allocator
  */
 class LineGroup {
 public:
+    using Labels = FlatSet<Label>;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+public:
+    /**
+     * @brief Constructs a group for a single line without any labels
+     *
+     * @param line_number 0-based line number
+     * @param allocator Allocator of the labels
+     */
+    explicit LineGroup(size_t line_number, const allocator_type& allocator = {});
+
     /**
      * @brief Constructs a group for a single line and its labels
      *
      * @param line_number 0-based line number
      * @param labels Labels associated with this line
+     * @param allocator Allocator of the labels
+     */
+    LineGroup(size_t line_number, Labels labels, const allocator_type& allocator = {});
+
+    LineGroup(const LineGroup& other) = default;
+    LineGroup(LineGroup&& other) noexcept = default;
+
+    /**
+     * @brief Copies a group into the memory of another allocator
+     *
+     * @param other Group to copy
+     * @param allocator Allocator of the copied labels
      */
-    LineGroup(size_t line_number, std::set<Label> labels);
+    LineGroup(const LineGroup& other, const allocator_type& allocator);
+
+    /**
+     * @brief Moves a group into the memory of another allocator
+     *
+     * @param other Group to move
+     * @param allocator Allocator of the moved labels
+     */
+    LineGroup(LineGroup&& other, const allocator_type& allocator);
+
+    LineGroup& operator=(const LineGroup& other) = default;
+    LineGroup& operator=(LineGroup&& other) noexcept = default;
 
     /**
      * @brief Returns the 0-based line number
@@ -47,35 +88,77 @@ public:
      *
      * @return Const reference to labels
      */
-    [[nodiscard]] const std::set<Label>& labels() const { return _labels; }
+    [[nodiscard]] const Labels& labels() const { return _labels; }
 
     /**
      * @brief Returns the set of labels for this line
      *
      * @return Reference to labels
      */
-    [[nodiscard]] std::set<Label>& labels() { return _labels; }
+    [[nodiscard]] Labels& labels() { return _labels; }
+
+    /**
+     * @brief Returns the allocator of the labels
+     *
+     * @return Allocator the group was created with
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return _labels.get_allocator(); }
 
 private:
-    std::set<Label> _labels;
+    Labels _labels;
     size_t _line_number;
 };
 
 /**
  * @brief Groups `LineGroup`s belonging to the same `Source`
+ *
+ * The line groups are kept sorted by their line number in one contiguous vector. The group
+ * and its line groups allocate from the memory resource of its allocator
  */
 class FileGroup {
 public:
-    using MappedLineGroups = std::map<size_t, LineGroup>;
+    using MappedLineGroups = FlatMap<size_t, LineGroup>;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
 
 public:
+    /**
+     * @brief Constructs a group for a source file without any line groups
+     *
+     * @param source Backing source for the group
+     * @param allocator Allocator of the line groups
+     */
+    explicit FileGroup(const std::shared_ptr<Source>& source, const allocator_type& allocator = {});
+
     /**
      * @brief Constructs a group for a source file with its line groups
      *
      * @param source Backing source for the group
      * @param line_groups Mapping from line number to line groups
+     * @param allocator Allocator of the line groups
+     */
+    FileGroup(const std::shared_ptr<Source>& source, MappedLineGroups line_groups, const allocator_type& allocator = {});
+
+    FileGroup(const FileGroup& other) = default;
+    FileGroup(FileGroup&& other) noexcept = default;
+
+    /**
+     * @brief Copies a group into the memory of another allocator
+     *
+     * @param other Group to copy
+     * @param allocator Allocator of the copied line groups
      */
-    FileGroup(const std::shared_ptr<Source>& source, MappedLineGroups line_groups);
+    FileGroup(const FileGroup& other, const allocator_type& allocator);
+
+    /**
+     * @brief Moves a group into the memory of another allocator
+     *
+     * @param other Group to move
+     * @param allocator Allocator of the moved line groups
+     */
+    FileGroup(FileGroup&& other, const allocator_type& allocator);
+
+    FileGroup& operator=(const FileGroup& other) = default;
+    FileGroup& operator=(FileGroup&& other) noexcept = default;
 
     /**
      * @brief Returns the map of line groups
@@ -98,6 +181,13 @@ public:
      */
     [[nodiscard]] const std::shared_ptr<Source>& source() const { return _source; }
 
+    /**
+     * @brief Returns the allocator of the line groups
+     *
+     * @return Allocator the group was created with
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return _line_groups.get_allocator(); }
+
 private:
     std::shared_ptr<Source> _source;
     MappedLineGroups _line_groups;
@@ -105,10 +195,16 @@ private:
 
 /**
  * @brief Represents a fully constructed diagnostic report to be rendered
+ *
+ * All strings and groups of a report allocate from the memory resource of its allocator.
+ * Building reports with an allocator of a `std::pmr::monotonic_buffer_resource` keeps a
+ * report, or a whole batch of them, in a single arena that is released at once, instead of
+ * allocating every group, label and text on its own
  */
 class Report {
 public:
-    using MappedFileGroups = std::unordered_map<std::shared_ptr<Source>, FileGroup>;
+    using MappedFileGroups = std::pmr::unordered_map<std::shared_ptr<Source>, FileGroup>;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
     class Builder;
 
 public:
@@ -121,9 +217,32 @@ public:
      * @param file_groups Mapping from sources to their file group
      * @param note Optional note for additional context
      * @param help Optional help text with suggestions
+     * @param allocator Allocator of the strings and groups
+     */
+    Report(std::string_view message, std::optional<std::string_view> code, Severity severity, MappedFileGroups file_groups,
+           std::optional<std::string_view> note, std::optional<std::string_view> help, const allocator_type& allocator = {});
+
+    Report(const Report& other) = default;
+    Report(Report&& other) noexcept = default;
+
+    /**
+     * @brief Copies a report into the memory of another allocator
+     *
+     * @param other Report to copy
+     * @param allocator Allocator of the copied strings and groups
+     */
+    Report(const Report& other, const allocator_type& allocator);
+
+    /**
+     * @brief Moves a report into the memory of another allocator
+     *
+     * @param other Report to move, its memory is only taken over if it uses the same allocator
+     * @param allocator Allocator of the moved strings and groups
      */
-    Report(std::string message, std::optional<std::string> code, Severity severity, MappedFileGroups file_groups, std::optional<std::string> note,
-           std::optional<std::string> help);
+    Report(Report&& other, const allocator_type& allocator);
+
+    Report& operator=(const Report& other) = default;
+    Report& operator=(Report&& other) noexcept = default;
 
     /**
      * @brief Renders the report using the provided renderer to the output stream
@@ -159,33 +278,43 @@ public:
      *
      * @return Message string
      */
-    [[nodiscard]] const std::string& message() const { return _message; }
+    [[nodiscard]] std::string_view message() const { return _message; }
 
     /**
      * @brief Returns an optional note with additional context
      *
      * @return Optional note string
      */
-    [[nodiscard]] const std::optional<std::string>& note() const { return _note; }
+    [[nodiscard]] std::optional<std::string_view> note() const { return _note ? std::optional<std::string_view>(*_note) : std::nullopt; }
 
     /**
      * @brief Returns optional help text with suggestions
      *
      * @return Optional help string
      */
-    [[nodiscard]] const std::optional<std::string>& help() const { return _help; }
+    [[nodiscard]] std::optional<std::string_view> help() const { return _help ? std::optional<std::string_view>(*_help) : std::nullopt; }
 
     /**
      * @brief Returns an optional error code or identifier
      *
      * @return Optional code string
      */
-    [[nodiscard]] const std::optional<std::string>& code() const { return _code; }
+    [[nodiscard]] std::optional<std::string_view> code() const { return _code ? std::optional<std::string_view>(*_code) : std::nullopt; }
+
+    /**
+     * @brief Returns the allocator of the strings and groups
+     *
+     * @return Allocator the report was created with
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return _message.get_allocator(); }
+
+private:
+    explicit Report(Builder&& builder);
 
 private:
-    std::optional<std::string> _code, _note, _help;
+    std::optional<std::pmr::string> _code, _note, _help;
     MappedFileGroups _file_groups;
-    std::string _message;
+    std::pmr::string _message;
     Severity _severity;
 };
 
@@ -231,9 +360,21 @@ public:
 
 /**
  * @brief Fluent builder for constructing `Report` instances
+ *
+ * The builder and the reports it builds allocate from the memory resource of its allocator
  */
 class Report::Builder {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
 public:
+    /**
+     * @brief Creates an empty builder
+     *
+     * @param allocator Allocator of the builder and the built reports
+     */
+    explicit Builder(const allocator_type& allocator = {});
+
     /**
      * @brief Sets report severity
      *
@@ -250,7 +391,7 @@ public:
      *
      * @return Reference to this builder
      */
-    Builder& message(std::string message);
+    Builder& message(std::string_view message);
 
     /**
      * @brief Sets an optional error code or identifier
@@ -259,17 +400,42 @@ public:
      *
      * @return Reference to this builder
      */
-    Builder& code(std::string code);
+    Builder& code(std::string_view code);
 
     /**
      * @brief Adds a label to the report
      *
+     * Finding an intersecting label of the same line is a binary search over the sorted labels
+     *
      * @param text Label message
      * @param span Source span the label refers to
      *
      * @return Reference to this builder
+     * @throws std::runtime_error If the text is empty or the span intersects another label of its line
+     */
+    Builder& label(std::string_view text, Span span);
+
+    /**
+     * @brief Adds a batch of labels to the report
+     *
+     * The labels are sorted once and checked for intersections in a single sweep, which is
+     * cheaper than adding them one by one. Nothing is added if any of them is rejected
+     *
+     * @param labels Labels in any order
+     *
+     * @return Reference to this builder
+     * @throws std::runtime_error If a text is empty or two spans of the same line intersect
      */
-    Builder& label(std::string text, Span span);
+    template <std::ranges::input_range Range>
+        requires std::constructible_from<Label, std::ranges::range_reference_t<Range>>
+    Builder& labels(Range&& labels) {
+        auto batch = std::pmr::vector<Label>(get_allocator());
+        if constexpr (std::ranges::sized_range<Range>) batch.reserve(std::ranges::size(labels));
+
+        for (auto&& label : labels) batch.emplace_back(std::forward<decltype(label)>(label));
+
+        return _insert_labels(std::move(batch));
+    }
 
     /**
      * @brief Sets an optional note
@@ -278,7 +444,7 @@ public:
      *
      * @return Reference to this builder
      */
-    Builder& note(std::string note);
+    Builder& note(std::string_view note);
 
     /**
      * @brief Sets optional help text
@@ -287,20 +453,53 @@ public:
      *
      * @return Reference to this builder
      */
-    Builder& help(std::string help);
+    Builder& help(std::string_view help);
+
+    /**
+     * @brief Builds a complete `Report`, copying the state of the builder
+     *
+     * @return The constructed report
+     * @throws std::exception If required fields are missing
+     */
+    [[nodiscard]] Report build() const &;
 
     /**
-     * @brief Builds a complete `Report`
+     * @brief Builds a complete `Report` by moving the state out of the builder
+     *
+     * No label or text is copied. Afterwards the builder is empty and can be used for the next report
      *
      * @return The constructed report
      * @throws std::exception If required fields are missing
      */
-    [[nodiscard]] Report build() const;
+    [[nodiscard]] Report build() &&;
+
+    /**
+     * @brief Removes every label and text, but keeps the memory of the groups
+     *
+     * Emitting many similar reports with one builder then reuses the storage of the lines
+     * that were labelled by the previous report, instead of allocating it again. Their
+     * sources are kept alive by the builder until the next reset that doesn't find them labelled
+     *
+     * @return Reference to this builder
+     */
+    Builder& reset();
+
+    /**
+     * @brief Returns the allocator of the builder
+     *
+     * @return Allocator the builder was created with
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return _file_groups.get_allocator(); }
 
 private:
-    std::optional<std::string> _message, _note, _help, _code;
+    Builder& _insert_labels(std::pmr::vector<Label> batch);
+
+private:
+    std::optional<std::pmr::string> _message, _note, _help, _code;
     std::optional<Severity> _severity;
     MappedFileGroups _file_groups;
+
+    friend class Report;
 };
 } // namespace pretty_diagnostics
 
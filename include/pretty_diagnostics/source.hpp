@@ -1,10 +1,18 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "index_cache.hpp"
+#include "line_index.hpp"
+#include "path_resolver.hpp"
+#include "unicode.hpp"
+
 namespace pretty_diagnostics {
 /**
  * @brief A position inside a `Source`, expressed as (row, column, index)
@@ -152,6 +160,19 @@ public:
      */
     [[nodiscard]] virtual std::string substr(const Location& start, const Location& end) const = 0;
 
+    /**
+     * @brief Returns a view of the text between two locations without copying it
+     *
+     * The view stays valid for as long as the source is alive, unless the implementation
+     * documents a shorter lifetime, which is extended for as long as a `pin()` is held
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return View of the text between @p start and @p end
+     */
+    [[nodiscard]] virtual std::string_view substr_view(const Location& start, const Location& end) const = 0;
+
     /**
      * @brief Returns the full line at the given location
      *
@@ -170,6 +191,30 @@ public:
      */
     [[nodiscard]] virtual std::string line(size_t line_number) const = 0;
 
+    /**
+     * @brief Returns a view of the full line at the given location without copying it
+     *
+     * The view stays valid for as long as the source is alive, unless the implementation
+     * documents a shorter lifetime, which is extended for as long as a `pin()` is held
+     *
+     * @param location A location within the desired line
+     *
+     * @return View of the line without a trailing newline
+     */
+    [[nodiscard]] virtual std::string_view line_view(const Location& location) const = 0;
+
+    /**
+     * @brief Returns a view of the specified line number without copying it
+     *
+     * The view stays valid for as long as the source is alive, unless the implementation
+     * documents a shorter lifetime, which is extended for as long as a `pin()` is held
+     *
+     * @param line_number 0-based line number
+     *
+     * @return View of the line without a trailing newline
+     */
+    [[nodiscard]] virtual std::string_view line_view(size_t line_number) const = 0;
+
     /**
      * @brief Returns the total number of lines in the source
      *
@@ -177,6 +222,73 @@ public:
      */
     [[nodiscard]] virtual size_t line_count() const = 0;
 
+    /**
+     * @brief Checks whether the source has the given line, without necessarily counting all lines
+     *
+     * @param line_number 0-based line number
+     *
+     * @return True if @p line_number is smaller than the line count
+     */
+    [[nodiscard]] virtual bool has_line(size_t line_number) const;
+
+    /**
+     * @brief Returns the absolute index at which the given line starts
+     *
+     * @param line_number 0-based line number
+     *
+     * @return 0-based index of the first character of the line
+     */
+    [[nodiscard]] virtual size_t line_start(size_t line_number) const;
+
+    /**
+     * @brief Converts a column in the given line from one unit into another
+     *
+     * The default implementation decodes the line, sources with a line index answer in O(1)
+     * for ASCII lines and O(log n) otherwise
+     *
+     * @param line_number 0-based line number
+     * @param column 0-based column in @p from
+     * @param from Unit of @p column
+     * @param to Unit of the returned column
+     *
+     * @return 0-based column in @p to
+     */
+    [[nodiscard]] virtual size_t convert_column(size_t line_number, size_t column, ColumnUnit from, ColumnUnit to) const;
+
+    /**
+     * @brief Returns the column of a location in the given unit
+     *
+     * @param location Location within this source
+     * @param unit Unit of the returned column
+     *
+     * @return 0-based column of @p location in @p unit
+     */
+    [[nodiscard]] size_t column(const Location& location, ColumnUnit unit) const;
+
+    /**
+     * @brief Returns a location corresponding to the given row and a column in the given unit
+     *
+     * @param row 0-based line number
+     * @param column 0-based column in @p unit
+     * @param unit Unit of @p column, e.g. `ColumnUnit::Utf16` for positions of a language client
+     *
+     * @return Mapped location
+     */
+    [[nodiscard]] Location from_unit_coords(size_t row, size_t column, ColumnUnit unit) const;
+
+    /**
+     * @brief Resolves a sorted sequence of absolute indices in a single forward walk
+     *
+     * Equivalent to calling `from_index()` for every index, but each line is only looked up
+     * and decoded once, which makes resolving all tokens of a source linear overall
+     *
+     * @param indices 0-based absolute character indices in ascending order
+     *
+     * @return Locations of @p indices in the same order
+     * @throws std::runtime_error If @p indices are not sorted or out of bounds
+     */
+    [[nodiscard]] std::vector<Location> from_indices(std::span<const size_t> indices) const;
+
     /**
      * @brief Returns the entire contents of the source
      *
@@ -184,6 +296,27 @@ public:
      */
     [[nodiscard]] virtual const std::string& contents() const = 0;
 
+    /**
+     * @brief Returns a view of the entire contents without copying them
+     *
+     * The view stays valid for as long as the source is alive, unless the implementation
+     * documents a shorter lifetime, which is extended for as long as a `pin()` is held
+     *
+     * @return View of the full source contents
+     */
+    [[nodiscard]] virtual std::string_view contents_view() const = 0;
+
+    /**
+     * @brief Keeps the views and references handed out by this source valid
+     *
+     * Sources that hand out views of a shorter lifetime keep the memory behind them while
+     * the returned handle is alive, and release it once the last handle is dropped. The
+     * default implementation returns an empty handle, as the views live as long as the source
+     *
+     * @return Handle that has to be dropped before the source is destroyed
+     */
+    [[nodiscard]] virtual std::shared_ptr<const void> pin() const;
+
     /**
      * @brief Returns a displayable path or identifier of the source
      *
@@ -199,6 +332,94 @@ public:
     [[nodiscard]] virtual size_t size() const = 0;
 };
 
+/**
+ * @brief Resolves absolute indices of a source that are mostly requested in ascending order
+ *
+ * The cursor keeps a copy of the line of the last index and remembers how far its columns
+ * were decoded, lines that only contain ASCII characters don't have to be decoded at all.
+ * Moving forward within the line only decodes the characters in between, moving to one of
+ * the next lines is a single line start lookup and larger jumps fall back to a binary search,
+ * so resolving every token of a lexer costs O(1) amortized per index. Moving backwards is
+ * supported, but resolves the index from the start of its line again.
+ *
+ * The cursor does not own the source, it has to outlive the cursor and must not change while
+ * the cursor is in use. Spans are created from
+ * the resolved locations, e.g. `Span(source, cursor.locate(start), cursor.locate(end))`
+ */
+class LocationCursor {
+public:
+    /**
+     * @brief Creates a cursor that is positioned at the start of the source
+     *
+     * @param source Source to resolve indices of
+     */
+    explicit LocationCursor(const Source& source);
+
+    /**
+     * @brief Returns the location of the given absolute index and moves the cursor there
+     *
+     * @param index 0-based absolute character index
+     *
+     * @return Same location as `Source::from_index()` returns
+     * @throws std::runtime_error If @p index is out of bounds
+     */
+    [[nodiscard]] Location locate(size_t index);
+
+private:
+    void _enter_row(size_t row);
+
+private:
+    const Source* _source;
+    size_t _size, _row, _row_start, _next_row_start;
+    size_t _target_column, _byte_column, _visual_column;
+    std::string _line;
+    bool _ascii;
+};
+
+/**
+ * @brief Creates a handle that refers to a source without owning it
+ *
+ * The handle shares no reference count with anything, so copying it, e.g. as part of every
+ * `Span` and `Label`, touches no atomics. The source has to be kept alive by other means for
+ * as long as a span refers to it, e.g. by a `SourceTable` or an owning handle held elsewhere
+ *
+ * @param source Source to refer to
+ *
+ * @return Non-owning handle to @p source
+ */
+template <typename T>
+[[nodiscard]] std::shared_ptr<T> borrow(T& source) {
+    return std::shared_ptr<T>(std::shared_ptr<T>(), &source);
+}
+
+/**
+ * @brief The contents of a file together with the stamp taken when they were read
+ */
+struct FileContents {
+    /**
+     * @brief The bytes of the file
+     */
+    std::string text;
+
+    /**
+     * @brief Size and modification time of the file as they were when it was read
+     */
+    FileStamp stamp;
+};
+
+/**
+ * @brief Reads a whole file into memory
+ *
+ * The file is opened and stat'ed only once, without building a line index, e.g. for
+ * files that are parsed instead of being used as a source
+ *
+ * @param path Path to the file on disk (absolute or relative)
+ *
+ * @return The contents and the stamp of the file
+ * @throws std::runtime_error If the file can't be read
+ */
+[[nodiscard]] FileContents read_file(const std::filesystem::path& path);
+
 /**
  * @brief A `Source` implementation that reads from an in-memory string
  */
@@ -209,8 +430,41 @@ public:
      *
      * @param contents Source contents held in memory
      * @param display_path Optional display identifier for diagnostics output
+     * @param config Options that control how the line index is built
+     */
+    explicit StringSource(std::string contents, std::string display_path = "<memory>", const IndexConfig& config = {});
+
+    /**
+     * @brief Copies the contents and the line index of another string source
+     *
+     * @param other Source to copy
+     */
+    StringSource(const StringSource& other);
+
+    /**
+     * @brief Moves the contents and the line index out of another string source
+     *
+     * @param other Source to move from
+     */
+    StringSource(StringSource&& other) noexcept;
+
+    /**
+     * @brief Replaces the source with a copy of another one
+     *
+     * @param other Source to copy
+     *
+     * @return Reference to this source
      */
-    explicit StringSource(std::string contents, std::string display_path = "<memory>");
+    StringSource& operator=(const StringSource& other);
+
+    /**
+     * @brief Replaces the source with another one
+     *
+     * @param other Source to move from
+     *
+     * @return Reference to this source
+     */
+    StringSource& operator=(StringSource&& other) noexcept;
 
     /**
      * @brief Maps (row, column) to a `Location` within the string
@@ -241,6 +495,16 @@ public:
      */
     [[nodiscard]] std::string substr(const Location& start, const Location& end) const override;
 
+    /**
+     * @brief Returns a view of the text between two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return View of the text between @p start and @p end
+     */
+    [[nodiscard]] std::string_view substr_view(const Location& start, const Location& end) const override;
+
     /**
      * @brief Returns the contents of the line containing the given location
      *
@@ -259,6 +523,24 @@ public:
      */
     [[nodiscard]] std::string line(size_t line_number) const override;
 
+    /**
+     * @brief Returns a view of the line containing the given location
+     *
+     * @param location A location within the desired line
+     *
+     * @return View of the line without a trailing newline
+     */
+    [[nodiscard]] std::string_view line_view(const Location& location) const override;
+
+    /**
+     * @brief Returns a view of the specified line number
+     *
+     * @param line_number 0-based line number
+     *
+     * @return View of the line without a trailing newline
+     */
+    [[nodiscard]] std::string_view line_view(size_t line_number) const override;
+
     /**
      * @brief Returns the total number of lines in the string
      *
@@ -266,6 +548,36 @@ public:
      */
     [[nodiscard]] size_t line_count() const override;
 
+    /**
+     * @brief Checks whether the string has the given line, scanning only as far as necessary
+     *
+     * @param line_number 0-based line number
+     *
+     * @return True if @p line_number is smaller than the line count
+     */
+    [[nodiscard]] bool has_line(size_t line_number) const override;
+
+    /**
+     * @brief Returns the absolute index at which the given line starts
+     *
+     * @param line_number 0-based line number
+     *
+     * @return 0-based index of the first character of the line
+     */
+    [[nodiscard]] size_t line_start(size_t line_number) const override;
+
+    /**
+     * @brief Converts a column in the given line from one unit into another
+     *
+     * @param line_number 0-based line number
+     * @param column 0-based column in @p from
+     * @param from Unit of @p column
+     * @param to Unit of the returned column
+     *
+     * @return 0-based column in @p to
+     */
+    [[nodiscard]] size_t convert_column(size_t line_number, size_t column, ColumnUnit from, ColumnUnit to) const override;
+
     /**
      * @brief Returns the entire contents of the source
      *
@@ -273,6 +585,13 @@ public:
      */
     [[nodiscard]] const std::string& contents() const override;
 
+    /**
+     * @brief Returns a view of the entire contents of the source
+     *
+     * @return View of the full source contents
+     */
+    [[nodiscard]] std::string_view contents_view() const override;
+
     /**
      * @brief Returns a displayable path or identifier of the source
      *
@@ -287,10 +606,30 @@ public:
      */
     [[nodiscard]] size_t size() const override;
 
+    /**
+     * @brief Returns the line index of the source
+     *
+     * @return Index used to resolve rows and columns, e.g. to inspect its memory usage
+     */
+    [[nodiscard]] const LineIndex& line_index() const { return _index; }
+
+protected:
+    /**
+     * @brief Creates a string source of a file's contents, restoring its line index from the cache if possible
+     *
+     * @param contents Contents of the file
+     * @param display_path Display path used in diagnostics
+     * @param file Path to the file on disk, used to look up the cached line index
+     * @param stamp Stamp of the file taken when @p contents were read
+     * @param config Options that control how the line index is built
+     */
+    StringSource(std::string contents, std::string display_path, const std::filesystem::path& file, const FileStamp& stamp,
+                 const IndexConfig& config);
+
 private:
-    std::vector<size_t> _line_starts;
     std::string _display_path;
     std::string _contents;
+    LineIndex _index;
 };
 
 /**
@@ -301,10 +640,27 @@ public:
     /**
      * @brief Creates a file source from a filesystem path
      *
+     * If `IndexConfig::cache_directory` is set, the line index is loaded from the cache
+     * instead of scanning the contents, and stored in it if there was no usable entry
+     *
      * @param path Path to the file on disk (absolute or relative)
      * @param working_path Optional path to make the path relative
+     * @param config Options that control how the line index is built
+     */
+    explicit FileSource(const std::filesystem::path& path, const std::filesystem::path& working_path = std::filesystem::current_path(),
+                        const IndexConfig& config = {});
+
+    /**
+     * @brief Creates a file source whose display path is taken from a shared resolver
+     *
+     * Opening many files this way only opens and stats each file once, since the display
+     * paths are computed lexically and remembered by @p resolver
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     * @param resolver Resolver of the display path, shared between sources
+     * @param config Options that control how the line index is built
      */
-    explicit FileSource(const std::filesystem::path& path, const std::filesystem::path& working_path = std::filesystem::current_path());
+    FileSource(const std::filesystem::path& path, const PathResolver& resolver, const IndexConfig& config = {});
 
     /**
      * @brief Equality compares path
@@ -327,7 +683,7 @@ public:
     friend bool operator!=(const FileSource& lhs, const FileSource& rhs) { return !(lhs == rhs); }
 
 private:
-    [[nodiscard]] static std::string _read_contents(const std::filesystem::path& path);
+    FileSource(FileContents contents, std::string display_path, const std::filesystem::path& path, const IndexConfig& config);
 };
 } // namespace pretty_diagnostics
 
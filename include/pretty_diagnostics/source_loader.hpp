@@ -0,0 +1,136 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "source.hpp"
+
+namespace pretty_diagnostics {
+/**
+ * @brief Configuration options for a `SourceLoader`
+ */
+struct LoaderConfig {
+    /**
+     * @brief Number of files that are read at the same time
+     *
+     * A value of 0 uses the hardware concurrency
+     */
+    size_t threads = 0;
+
+    /**
+     * @brief Path that the display paths of the sources are made relative to
+     */
+    std::filesystem::path working_path = std::filesystem::current_path();
+
+    /**
+     * @brief Options that control how the line indices of the sources are built
+     */
+    IndexConfig index = {};
+
+    /**
+     * @brief Resolver of the display paths, shared with other loaders or sources
+     *
+     * If not set, the loader creates its own resolver for `working_path`
+     */
+    std::shared_ptr<const PathResolver> resolver = nullptr;
+};
+
+/**
+ * @brief Loads file sources on a pool of worker threads
+ *
+ * Reading many files one after another adds up their latencies, the loader overlaps them
+ * by handing the files to its workers and returning a future for every source right away.
+ * Errors while loading a file are stored in its future. Destroying the loader waits until
+ * every queued file was loaded
+ */
+class SourceLoader {
+public:
+    /**
+     * @brief Starts the worker threads
+     *
+     * @param config Options that control the workers and how sources are loaded
+     */
+    explicit SourceLoader(const LoaderConfig& config = {});
+
+    /**
+     * @brief Loads the remaining queued files and stops the worker threads
+     */
+    ~SourceLoader();
+
+    SourceLoader(const SourceLoader&) = delete;
+    SourceLoader& operator=(const SourceLoader&) = delete;
+
+    /**
+     * @brief Queues a single file to be loaded
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     *
+     * @return Future of the loaded source, holding an exception if the file can't be read
+     */
+    [[nodiscard]] std::future<std::shared_ptr<FileSource>> load(std::filesystem::path path);
+
+    /**
+     * @brief Queues a batch of files to be loaded
+     *
+     * @param paths Paths to the files on disk (absolute or relative)
+     *
+     * @return Futures of the loaded sources, in the order of @p paths
+     */
+    [[nodiscard]] std::vector<std::future<std::shared_ptr<FileSource>>> load(std::span<const std::filesystem::path> paths);
+
+private:
+    /**
+     * @brief A queued file together with the promise of its source
+     */
+    struct Task {
+        std::filesystem::path path;
+        std::promise<std::shared_ptr<FileSource>> promise;
+    };
+
+    void _work(const std::stop_token& stop_token);
+
+private:
+    LoaderConfig _config;
+    std::shared_ptr<const PathResolver> _resolver;
+    std::deque<Task> _queue;
+    std::mutex _mutex;
+    std::condition_variable_any _condition;
+    std::vector<std::jthread> _workers;
+};
+} // namespace pretty_diagnostics
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,362 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "source.hpp"
+
+namespace pretty_diagnostics {
+/**
+ * @brief Configuration options for a `SourceManager`
+ */
+struct ManagerConfig {
+    /**
+     * @brief Upper bound in bytes for the contents and line indices kept in memory
+     *
+     * Once exceeded, the least recently used sources that aren't pinned are evicted. A value of 0 never evicts
+     */
+    size_t byte_budget = 0;
+
+    /**
+     * @brief Number of files that `SourceManager::open_all()` reads at the same time
+     *
+     * A value of 0 uses the hardware concurrency. The worker threads are started by the first
+     * call and kept for the lifetime of the manager
+     */
+    size_t threads = 0;
+
+    /**
+     * @brief Path that the display paths of the sources are made relative to
+     */
+    std::filesystem::path working_path = std::filesystem::current_path();
+
+    /**
+     * @brief Options that control how the line indices of the sources are built
+     */
+    IndexConfig index = {};
+};
+
+class ManagedSource;
+
+/**
+ * @brief Interns file sources by their canonical path and keeps their memory within a budget
+ *
+ * Opening the same file twice, even through different paths, hands out the same source,
+ * so its contents are only kept once and all its spans land in the same file group of a
+ * report. Sources stay interned for as long as a handle to them is alive.
+ *
+ * When the loaded sources exceed the byte budget, the least recently used ones release
+ * their contents and line index, which are loaded again on their next access. All members
+ * are safe to be called concurrently
+ */
+class SourceManager {
+public:
+    /**
+     * @brief Creates a manager without any sources
+     *
+     * @param config Options that control the budget and how sources are loaded
+     */
+    explicit SourceManager(const ManagerConfig& config = {});
+
+    SourceManager(const SourceManager&) = delete;
+    SourceManager& operator=(const SourceManager&) = delete;
+
+    /**
+     * @brief Returns the source of the given file, loading it if necessary
+     *
+     * @param path Path to the file on disk (absolute or relative)
+     *
+     * @return Handle that is shared by every caller opening the same file
+     * @throws std::runtime_error If the file can't be read
+     */
+    [[nodiscard]] std::shared_ptr<ManagedSource> open(const std::filesystem::path& path);
+
+    /**
+     * @brief Returns the sources of the given files, loading the missing ones concurrently
+     *
+     * @param paths Paths to the files on disk (absolute or relative)
+     *
+     * @return Handles in the order of @p paths
+     * @throws std::runtime_error If any of the files can't be read
+     */
+    [[nodiscard]] std::vector<std::shared_ptr<ManagedSource>> open_all(std::span<const std::filesystem::path> paths);
+
+    /**
+     * @brief Returns the number of bytes currently held by loaded sources
+     *
+     * @return Size of the loaded contents plus their line indices
+     */
+    [[nodiscard]] size_t resident_bytes() const;
+
+    /**
+     * @brief Returns the number of interned sources that have a handle alive
+     *
+     * @return Number of distinct files, loaded or evicted
+     */
+    [[nodiscard]] size_t source_count() const;
+
+private:
+    struct Registry;
+
+    [[nodiscard]] std::shared_ptr<ManagedSource> _find(const std::filesystem::path& canonical_path) const;
+
+    [[nodiscard]] std::shared_ptr<ManagedSource> _adopt(const std::filesystem::path& canonical_path, std::shared_ptr<const FileSource> loaded);
+
+private:
+    std::shared_ptr<Registry> _registry;
+
+    friend class ManagedSource;
+};
+
+/**
+ * @brief A handle to a file source owned by a `SourceManager`
+ *
+ * Every access loads the file again if it was evicted in the meantime. Views and references
+ * are only handed out while the source is pinned by a handle of `pin()`. A pinned source is
+ * never evicted, so its views and references stay valid for as long as any of its pins is
+ * alive, even while other sources are loaded concurrently. Pinned sources count against the
+ * byte budget, they become evictable again once their last pin is dropped
+ */
+class ManagedSource final : public Source, public std::enable_shared_from_this<ManagedSource> {
+public:
+    ~ManagedSource() override;
+
+    ManagedSource(const ManagedSource&) = delete;
+    ManagedSource& operator=(const ManagedSource&) = delete;
+
+    /**
+     * @brief Checks whether the contents of the file are currently in memory
+     *
+     * @return False if the source was evicted and will be loaded on its next access
+     */
+    [[nodiscard]] bool is_loaded() const;
+
+    /**
+     * @brief Checks whether a handle of `pin()` is alive
+     *
+     * @return True if the source can't be evicted until its last pin is dropped
+     */
+    [[nodiscard]] bool is_pinned() const;
+
+    /**
+     * @brief Maps (row, column) to a `Location` within the file
+     *
+     * @param row 0-based line number
+     * @param column 0-based column number
+     *
+     * @return Location corresponding to the given coordinates
+     */
+    [[nodiscard]] Location from_coords(size_t row, size_t column) const override;
+
+    /**
+     * @brief Maps an absolute index to a `Location` within the file
+     *
+     * @param index 0-based absolute character index
+     *
+     * @return Location corresponding to the given index
+     */
+    [[nodiscard]] Location from_index(size_t index) const override;
+
+    /**
+     * @brief Extracts the substring between two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return Substring between @p start and @p end
+     */
+    [[nodiscard]] std::string substr(const Location& start, const Location& end) const override;
+
+    /**
+     * @brief Returns a view of the text between two locations
+     *
+     * @param start Inclusive start location
+     * @param end Exclusive end location
+     *
+     * @return View of the text, valid while the source is pinned
+     * @throws std::runtime_error If the source is not pinned
+     */
+    [[nodiscard]] std::string_view substr_view(const Location& start, const Location& end) const override;
+
+    /**
+     * @brief Returns the full line containing the given location
+     *
+     * @param location A location within the desired line
+     *
+     * @return The entire line contents without a trailing newline
+     */
+    [[nodiscard]] std::string line(const Location& location) const override;
+
+    /**
+     * @brief Returns the contents of the specified line number
+     *
+     * @param line_number 0-based line number
+     *
+     * @return The entire line contents without a trailing newline
+     */
+    [[nodiscard]] std::string line(size_t line_number) const override;
+
+    /**
+     * @brief Returns a view of the full line containing the given location
+     *
+     * @param location A location within the desired line
+     *
+     * @return View of the line without a trailing newline, valid while the source is pinned
+     * @throws std::runtime_error If the source is not pinned
+     */
+    [[nodiscard]] std::string_view line_view(const Location& location) const override;
+
+    /**
+     * @brief Returns a view of the specified line number
+     *
+     * @param line_number 0-based line number
+     *
+     * @return View of the line without a trailing newline, valid while the source is pinned
+     * @throws std::runtime_error If the source is not pinned
+     */
+    [[nodiscard]] std::string_view line_view(size_t line_number) const override;
+
+    /**
+     * @brief Returns the number of lines in the file
+     *
+     * @return Line count
+     */
+    [[nodiscard]] size_t line_count() const override;
+
+    /**
+     * @brief Checks whether the file has the given line
+     *
+     * @param line_number 0-based line number
+     *
+     * @return True if @p line_number is smaller than the line count
+     */
+    [[nodiscard]] bool has_line(size_t line_number) const override;
+
+    /**
+     * @brief Returns the absolute index at which the given line starts
+     *
+     * @param line_number 0-based line number
+     *
+     * @return 0-based index of the first character of the line
+     */
+    [[nodiscard]] size_t line_start(size_t line_number) const override;
+
+    /**
+     * @brief Converts a column in the given line from one unit into another
+     *
+     * @param line_number 0-based line number
+     * @param column 0-based column in @p from
+     * @param from Unit of @p column
+     * @param to Unit of the returned column
+     *
+     * @return 0-based column in @p to
+     */
+    [[nodiscard]] size_t convert_column(size_t line_number, size_t column, ColumnUnit from, ColumnUnit to) const override;
+
+    /**
+     * @brief Returns the entire contents of the file
+     *
+     * @return Full file contents, valid while the source is pinned
+     * @throws std::runtime_error If the source is not pinned
+     */
+    [[nodiscard]] const std::string& contents() const override;
+
+    /**
+     * @brief Returns a view of the entire contents of the file
+     *
+     * @return View of the full file contents, valid while the source is pinned
+     * @throws std::runtime_error If the source is not pinned
+     */
+    [[nodiscard]] std::string_view contents_view() const override;
+
+    /**
+     * @brief Loads the source if necessary and keeps it from being evicted
+     *
+     * @return Handle that keeps the source and its contents alive until it is dropped
+     */
+    [[nodiscard]] std::shared_ptr<const void> pin() const override;
+
+    /**
+     * @brief Returns a displayable path or identifier of the source
+     *
+     * @return Display path or identifier
+     */
+    [[nodiscard]] std::string path() const override;
+
+    /**
+     * @brief Returns the total size (in characters) of the file
+     *
+     * @return Size in characters
+     */
+    [[nodiscard]] size_t size() const override;
+
+private:
+    ManagedSource(std::shared_ptr<SourceManager::Registry> registry, std::filesystem::path path, const FileSource& loaded);
+
+    [[nodiscard]] std::shared_ptr<const FileSource> _acquire() const;
+
+    [[nodiscard]] std::shared_ptr<const FileSource> _pinned(std::string_view function) const;
+
+    void _unpin() const;
+
+private:
+    std::shared_ptr<SourceManager::Registry> _registry;
+    std::filesystem::path _path;
+    std::string _display_path;
+    size_t _size;
+
+    mutable std::shared_ptr<const FileSource> _loaded;
+    mutable size_t _resident_bytes;
+    mutable std::atomic<uint64_t> _last_access;
+    mutable std::atomic<size_t> _pins;
+    mutable std::mutex _mutex;
+
+    friend class SourceManager;
+};
+} // namespace pretty_diagnostics
+
+/**
+ * @brief Streams a readable description of a `ManagedSource`
+ *
+ * @param os Output stream to write to
+ * @param source Source to describe
+ *
+ * @return Reference to @p os.
+ */
+std::ostream& operator<<(std::ostream& os, const pretty_diagnostics::ManagedSource& source);
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "source.hpp"
+#include "span.hpp"
+
+namespace pretty_diagnostics {
+/**
+ * @brief A decoded segment of a source map, linking a generated position to an original one
+ *
+ * Columns are counted in UTF-16 code units, as the source map format demands
+ */
+struct SourceMapSegment {
+    uint32_t generated_row;    ///< 0-based line within the generated code
+    uint32_t generated_column; ///< 0-based UTF-16 column within the generated code
+    uint32_t source;           ///< Index into `SourceMap::sources()`
+    uint32_t original_row;     ///< 0-based line within the original source
+    uint32_t original_column;  ///< 0-based UTF-16 column within the original source
+};
+
+/**
+ * @brief A parsed version 3 source map
+ *
+ * The VLQ encoded mappings are decoded once while parsing into a table of absolute
+ * segments, sorted by their generated position, so every lookup is a binary search.
+ * Segments without an original position end the mapped range before them and are kept
+ * as gaps. Names and index maps with sections are not supported
+ */
+class SourceMap {
+public:
+    /**
+     * @brief Parses the JSON text of a source map
+     *
+     * @param json Contents of the `.map` file
+     *
+     * @return The parsed source map
+     * @throws std::runtime_error If the JSON or the mappings are malformed, or the version isn't 3
+     */
+    [[nodiscard]] static SourceMap parse(std::string_view json);
+
+    /**
+     * @brief Finds the segment that covers a generated position
+     *
+     * @param row 0-based line within the generated code
+     * @param column 0-based UTF-16 column within the generated code
+     *
+     * @return The last segment at or before the position in the same row, or `nullptr` if
+     *         the position isn't mapped
+     */
+    [[nodiscard]] const SourceMapSegment* find(size_t row, size_t column) const;
+
+    /**
+     * @brief Returns the original sources, with the source root already prepended
+     *
+     * @return Paths of the original sources as written in the map
+     */
+    [[nodiscard]] const std::vector<std::string>& sources() const { return _sources; }
+
+    /**
+     * @brief Returns the embedded contents of the original sources
+     *
+     * @return Contents in the order of `sources()`, `std::nullopt` where none were embedded
+     */
+    [[nodiscard]] const std::vector<std::optional<std::string>>& sources_content() const { return _sources_content; }
+
+    /**
+     * @brief Returns the decoded segments
+     *
+     * @return Segments sorted by their generated position
+     */
+    [[nodiscard]] const std::vector<SourceMapSegment>& segments() const { return _segments; }
+
+    /**
+     * @brief Returns the name of the generated file, if the map contains one
+     *
+     * @return Value of the `file` field
+     */
+    [[nodiscard]] const std::optional<std::string>& file() const { return _file; }
+
+private:
+    /**
+     * @brief Marks segments that only have a generated position and end the mapped range
+     */
+    static constexpr uint32_t UNMAPPED = UINT32_MAX;
+
+    void _decode(std::string_view mappings);
+
+private:
+    std::vector<std::string> _sources;
+    std::vector<std::optional<std::string>> _sources_content;
+    std::vector<SourceMapSegment> _segments;
+    std::optional<std::string> _file;
+};
+
+/**
+ * @brief A location within one of the original sources of a source map
+ */
+struct OriginalLocation {
+    std::shared_ptr<Source> source; ///< Original source
+    Location location;              ///< Location within @p source
+};
+
+/**
+ * @brief A `Source` implementation for generated code that knows its original locations
+ *
+ * Holds the generated code like a `StringSource` together with its source map and the
+ * original sources the map refers to. Generated locations are translated into original ones
+ * by looking up their segment in O(log n), the mappings are never decoded again. Positions
+ * after the start of a segment keep their distance to it in the original source, clamped to
+ * the end of the original line
+ */
+class SourceMapSource final : public StringSource {
+public:
+    /**
+     * @brief Creates a source from generated code, its source map and the original sources
+     *
+     * @param contents Generated code
+     * @param map Source map of the generated code
+     * @param originals Original sources in the order of `SourceMap::sources()`
+     * @param display_path Optional display identifier for diagnostics output
+     *
+     * @throws std::runtime_error If the number of original sources doesn't match the map
+     */
+    SourceMapSource(std::string contents, SourceMap map, std::vector<std::shared_ptr<Source>> originals, std::string display_path = "<generated>");
+
+    /**
+     * @brief Loads generated code together with its source map and original sources from disk
+     *
+     * The original sources are looked up relative to the directory of the map. A source that
+     * doesn't exist on disk falls back to the contents embedded in the map
+     *
+     * @param path Path to the generated file
+     * @param map_path Path to the source map, `path` with a `.map` suffix if empty
+     * @param working_path Path that the display paths are made relative to
+     *
+     * @return The loaded source
+     * @throws std::runtime_error If a file can't be read or the source map is malformed
+     */
+    [[nodiscard]] static std::shared_ptr<SourceMapSource> open(const std::filesystem::path& path, const std::filesystem::path& map_path = {},
+                                                               const std::filesystem::path& working_path = std::filesystem::current_path());
+
+    /**
+     * @brief Translates a generated location into its original location
+     *
+     * @param location Location within the generated code
+     *
+     * @return The original source and location, or `std::nullopt` if @p location isn't mapped
+     */
+    [[nodiscard]] std::optional<OriginalLocation> original(const Location& location) const;
+
+    /**
+     * @brief Translates a span of the generated code into its original source
+     *
+     * If the end of the span maps into another source or in front of its start, the
+     * original span only covers the first character at its start
+     *
+     * @param span Span within this source
+     *
+     * @return Span within the original source, or `std::nullopt` if the start of @p span isn't mapped
+     * @throws std::runtime_error If @p span belongs to another source
+     */
+    [[nodiscard]] std::optional<Span> to_original(const Span& span) const;
+
+    /**
+     * @brief Returns the source map
+     *
+     * @return Parsed source map of the generated code
+     */
+    [[nodiscard]] const SourceMap& map() const { return _map; }
+
+    /**
+     * @brief Returns the original sources
+     *
+     * @return Sources in the order of `SourceMap::sources()`
+     */
+    [[nodiscard]] const std::vector<std::shared_ptr<Source>>& originals() const { return _originals; }
+
+private:
+    [[nodiscard]] std::optional<OriginalLocation> _translate(size_t row, size_t lookup_column, size_t column) const;
+
+    [[nodiscard]] size_t _utf16_column(const Location& location) const;
+
+private:
+    SourceMap _map;
+    std::vector<std::shared_ptr<Source>> _originals;
+};
+} // namespace pretty_diagnostics
+
+/**
+ * @brief Streams a readable description of a `SourceMapSource`
+ *
+ * @param os Output stream to write to
+ * @param source Source to describe
+ *
+ * @return Reference to @p os.
+ */
+std::ostream& operator<<(std::ostream& os, const pretty_diagnostics::SourceMapSource& source);
+
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace pretty_diagnostics {
+/**
+ * @brief Units in which a column within a line can be counted
+ */
+enum class ColumnUnit {
+    Byte,      ///< UTF-8 code units, the unit of `Location::index()`
+    CodePoint, ///< Unicode scalar values
+    Utf16,     ///< UTF-16 code units, as used by the language server protocol
+    Visual,    ///< Terminal columns, the unit of `Location::column()`
+};
+
+/**
+ * @brief A code point decoded from UTF-8 together with the number of bytes it takes
+ */
+struct DecodedChar {
+    char32_t code_point;
+    size_t byte_count;
+};
+
+/**
+ * @brief Decodes the UTF-8 sequence at the given index
+ *
+ * Truncated sequences, overlong encodings, surrogates and stray continuation bytes are
+ * decoded as U+FFFD with a byte count of 1, so decoding always makes progress
+ *
+ * @param input Text that contains the sequence
+ * @param index Index of the first byte of the sequence, must be smaller than the size of @p input
+ *
+ * @return The decoded code point and the length of its sequence
+ */
+[[nodiscard]] DecodedChar decode_utf8(std::string_view input, size_t index);
+
+/**
+ * @brief Returns the number of terminal columns a single code point occupies
+ *
+ * Wide and fullwidth characters of the East Asian Width property as well as emoji take two
+ * columns, combining marks, format characters and other code points that attach to their
+ * predecessor take none. The widths are looked up in a two-level table generated at compile time
+ *
+ * @param code_point Code point to measure
+ *
+ * @return 0, 1 or 2
+ */
+[[nodiscard]] size_t codepoint_width(char32_t code_point);
+
+/**
+ * @brief Checks whether a code point extends the character before it instead of starting a new one
+ *
+ * @param code_point Code point to check
+ *
+ * @return True for zero-width code points and emoji skin tone modifiers
+ */
+[[nodiscard]] bool is_grapheme_extender(char32_t code_point);
+
+/**
+ * @brief Returns the column of a byte column in the given unit
+ *
+ * Counts every character that starts before the byte column, the same way `to_visual_column()` does
+ *
+ * @param line Input UTF-8 string view (usually a single line)
+ * @param byte_column 0-based byte column into @p line
+ * @param unit Unit of the returned column
+ *
+ * @return 0-based column in @p unit
+ */
+[[nodiscard]] size_t to_column(std::string_view line, size_t byte_column, ColumnUnit unit);
+
+/**
+ * @brief Returns the byte column of a column in the given unit
+ *
+ * Stops at the last character that ends at or before the column, the same way `from_visual_column()` does
+ *
+ * @param line Input UTF-8 string view (usually a single line)
+ * @param column 0-based column in @p unit
+ * @param unit Unit of @p column
+ *
+ * @return 0-based byte column into @p line
+ */
+[[nodiscard]] size_t from_column(std::string_view line, size_t column, ColumnUnit unit);
+
+/**
+ * @brief Converts a column within a line from one unit into another
+ *
+ * @param line Input UTF-8 string view (usually a single line)
+ * @param column 0-based column in @p from
+ * @param from Unit of @p column
+ * @param to Unit of the returned column
+ *
+ * @return 0-based column in @p to
+ */
+[[nodiscard]] size_t convert_column(std::string_view line, size_t column, ColumnUnit from, ColumnUnit to);
+} // namespace pretty_diagnostics
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -72,6 +72,15 @@ T min(T first, Ts... rest) {
 
 size_t get_stream_width(const std::ostream &stream);
 
+/**
+ * @brief Returns the length of the leading run of ASCII characters, scanning 16 bytes at a time where possible
+ *
+ * @param input Input string view
+ *
+ * @return Number of bytes before the first byte that is not ASCII, the size of @p input if there is none
+ */
+[[nodiscard]] size_t ascii_prefix_length(std::string_view input);
+
 /**
  * @brief A structure to contian the return values from `get_visual_char`
  */
@@ -83,17 +92,22 @@ struct VisualChar {
 /**
  * @brief Returns the visual width and byte count of a given UTF8 character
  *
+ * A character spans all code points that are displayed as one: combining marks and other
+ * zero-width code points belong to the character before them, and so do skin tones, the
+ * second half of a flag and emoji that are joined to the previous one by a zero width joiner
+ *
  * @param input The input stringview that contains the UTF8 character
  * @param index The index at which the character is located
- * @return
+ * @return The width of the whole character and the number of bytes it spans
  */
 [[nodiscard]] VisualChar get_visual_char(std::string_view input, size_t index);
 
 /**
  * @brief Calculates the visual display width of a UTF-8 string (for terminal display)
  *
- * ASCII characters count as 1, most 3- and 4-byte characters (CJK, emojis) as 2.
- * Invalid UTF-8 bytes are counted as width 1.
+ * ASCII characters count as 1, wide characters (CJK, emojis) as 2 and combining characters
+ * as 0, see `codepoint_width()`. Invalid UTF-8 bytes are counted as width 1. Runs of ASCII
+ * are measured 16 or 32 bytes at a time.
  *
  * @param input Input UTF-8 string view
  *
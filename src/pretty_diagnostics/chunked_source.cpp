@@ -0,0 +1,552 @@
+#include "pretty_diagnostics/chunked_source.hpp"
+#include "pretty_diagnostics/line_index.hpp"
+#include "pretty_diagnostics/utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace pretty_diagnostics;
+
+// Bytes that follow a character when it is decoded from a stream, enough to decode the next character as well
+constexpr size_t STREAM_LOOKAHEAD = 16;
+
+static size_t code_units(const char32_t code_point, const ColumnUnit unit) {
+    return (unit == ColumnUnit::Utf16 && code_point > 0xFFFF) ? 2 : 1;
+}
+
+// Every byte is a unit of its own and so is every ASCII character, except for the last one of a run that a combining
+// character could extend, which is left to be decoded as a whole character. The run is bounded by the remaining units.
+static size_t unit_run(const std::string_view ahead, const size_t remaining, const ColumnUnit unit, const bool line_ended) {
+    if (unit == ColumnUnit::Byte) return std::min(remaining, ahead.size());
+
+    const auto run = ascii_prefix_length(ahead.substr(0, remaining + 1));
+    if (run > remaining) return remaining;
+
+    return (run > 0 && unit == ColumnUnit::Visual && !(line_ended && run == ahead.size())) ? run - 1 : run;
+}
+
+ChunkedFileSource::File::File(const std::filesystem::path& path) {
+#ifdef _WIN32
+    handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        handle = nullptr;
+        throw std::runtime_error("ChunkedFileSource::File::File(): could not open file: " + path.string());
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(handle, &file_size)) {
+        CloseHandle(handle);
+        throw std::runtime_error("ChunkedFileSource::File::File(): failed to determine file size: " + path.string());
+    }
+
+    size = static_cast<size_t>(file_size.QuadPart);
+#else
+    descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor == -1) {
+        throw std::runtime_error("ChunkedFileSource::File::File(): could not open file: " + path.string());
+    }
+
+    struct stat file_stat{};
+    if (::fstat(descriptor, &file_stat) == -1) {
+        ::close(descriptor);
+        throw std::runtime_error("ChunkedFileSource::File::File(): failed to determine file size: " + path.string());
+    }
+
+    size = static_cast<size_t>(file_stat.st_size);
+#endif
+}
+
+ChunkedFileSource::File::~File() {
+#ifdef _WIN32
+    if (handle != nullptr) CloseHandle(handle);
+#else
+    if (descriptor != -1) ::close(descriptor);
+#endif
+}
+
+void ChunkedFileSource::File::read(char* output, size_t count, size_t offset) const {
+    while (count > 0) {
+#ifdef _WIN32
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+
+        DWORD read_bytes = 0;
+        const auto request = static_cast<DWORD>(std::min<size_t>(count, MAXDWORD));
+        if (!ReadFile(handle, output, request, &read_bytes, &overlapped) || read_bytes == 0) {
+            throw std::runtime_error("ChunkedFileSource::File::read(): failed to read file");
+        }
+#else
+        const auto read_bytes = ::pread(descriptor, output, count, static_cast<off_t>(offset));
+        if (read_bytes == -1 && errno == EINTR) continue;
+        if (read_bytes <= 0) {
+            throw std::runtime_error("ChunkedFileSource::File::read(): failed to read file");
+        }
+#endif
+
+        output += read_bytes;
+        offset += static_cast<size_t>(read_bytes);
+        count -= static_cast<size_t>(read_bytes);
+    }
+}
+
+ChunkedFileSource::ChunkedFileSource(const std::filesystem::path& path, const std::filesystem::path& working_path, const WindowConfig& config) :
+    _display_path(std::filesystem::relative(path, working_path).string()), _file(path), _window_size(config.window_size),
+    _max_windows(config.max_windows), _rows_before{ 0 }, _pins(0) {
+    if (_window_size == 0 || _max_windows == 0) {
+        throw std::runtime_error("ChunkedFileSource::ChunkedFileSource(): windows must not be empty");
+    }
+}
+
+Location ChunkedFileSource::from_coords(const size_t row, const size_t column) const {
+    const std::lock_guard lock(_mutex);
+    if (!_contains_row(row)) {
+        throw std::runtime_error("ChunkedFileSource::from_coords(): invalid coordinates, there are not enough rows present");
+    }
+
+    const auto byte_column = _from_column(row, column, ColumnUnit::Visual);
+    return { row, column, _line_start(row) + byte_column };
+}
+
+Location ChunkedFileSource::from_index(const size_t index) const {
+    if (index > _file.size) {
+        throw std::runtime_error("ChunkedFileSource::from_index(): invalid index, out of bounds");
+    }
+
+    const std::lock_guard lock(_mutex);
+    const auto row = _row(index);
+    const auto byte_column = index - _line_start(row);
+
+    return { row, _to_column(row, byte_column, ColumnUnit::Visual), index };
+}
+
+std::string ChunkedFileSource::substr(const Location& start, const Location& end) const {
+    const auto start_index = start.index();
+    const auto end_index = end.index();
+
+    if (end_index < start_index || end_index > _file.size) {
+        throw std::runtime_error("ChunkedFileSource::substr(): invalid range");
+    }
+
+    const std::lock_guard lock(_mutex);
+    return _read(start_index, end_index);
+}
+
+std::string_view ChunkedFileSource::substr_view(const Location& start, const Location& end) const {
+    const auto start_index = start.index();
+    const auto end_index = end.index();
+
+    if (end_index < start_index || end_index > _file.size) {
+        throw std::runtime_error("ChunkedFileSource::substr_view(): invalid range");
+    }
+
+    const std::lock_guard lock(_mutex);
+    return _view(start_index, end_index);
+}
+
+std::string ChunkedFileSource::line(const Location& location) const {
+    return ChunkedFileSource::line(location.row());
+}
+
+std::string ChunkedFileSource::line(const size_t line_number) const {
+    const std::lock_guard lock(_mutex);
+    if (!_contains_row(line_number)) {
+        throw std::runtime_error("ChunkedFileSource::line(): invalid line number, there are not enough lines present");
+    }
+
+    return _line(line_number);
+}
+
+std::string_view ChunkedFileSource::line_view(const Location& location) const {
+    return ChunkedFileSource::line_view(location.row());
+}
+
+std::string_view ChunkedFileSource::line_view(const size_t line_number) const {
+    const std::lock_guard lock(_mutex);
+    if (!_contains_row(line_number)) {
+        throw std::runtime_error("ChunkedFileSource::line_view(): invalid line number, there are not enough lines present");
+    }
+
+    const auto [start, end] = _line_range(line_number);
+    return _view(start, end);
+}
+
+size_t ChunkedFileSource::line_count() const {
+    const std::lock_guard lock(_mutex);
+    _scan_windows(_window_count());
+    return _rows_before.back() + 1;
+}
+
+bool ChunkedFileSource::has_line(const size_t line_number) const {
+    const std::lock_guard lock(_mutex);
+    return _contains_row(line_number);
+}
+
+size_t ChunkedFileSource::line_start(const size_t line_number) const {
+    const std::lock_guard lock(_mutex);
+    if (!_contains_row(line_number)) {
+        throw std::runtime_error("ChunkedFileSource::line_start(): invalid line number, there are not enough lines present");
+    }
+
+    return _line_start(line_number);
+}
+
+size_t ChunkedFileSource::convert_column(const size_t line_number, const size_t column, const ColumnUnit from, const ColumnUnit to) const {
+    const std::lock_guard lock(_mutex);
+    if (!_contains_row(line_number)) {
+        throw std::runtime_error("ChunkedFileSource::convert_column(): invalid line number, there are not enough lines present");
+    }
+
+    return _to_column(line_number, _from_column(line_number, column, from), to);
+}
+
+const std::string& ChunkedFileSource::contents() const {
+    throw std::runtime_error("ChunkedFileSource::contents(): not supported, the whole file is never held in memory");
+}
+
+std::string_view ChunkedFileSource::contents_view() const {
+    throw std::runtime_error("ChunkedFileSource::contents_view(): not supported, the whole file is never held in memory");
+}
+
+std::shared_ptr<const void> ChunkedFileSource::pin() const {
+    const std::lock_guard lock(_mutex);
+    ++_pins;
+
+    return { this, [](const ChunkedFileSource* source) { source->_unpin(); } };
+}
+
+std::string ChunkedFileSource::path() const {
+    return _display_path;
+}
+
+size_t ChunkedFileSource::size() const {
+    return _file.size;
+}
+
+size_t ChunkedFileSource::memory_usage() const {
+    const std::lock_guard lock(_mutex);
+
+    auto usage = _rows_before.capacity() * sizeof(size_t) + _window_lookup.bucket_count() * sizeof(void*);
+    for (const auto& window : _windows) {
+        usage += sizeof(Window) + window.data->capacity();
+    }
+
+    // Pinned windows that are still resident were already counted above.
+    usage += _pinned_windows.bucket_count() * sizeof(void*);
+    for (const auto& [number, data] : _pinned_windows) {
+        if (!_window_lookup.contains(number)) usage += data->capacity();
+    }
+
+    for (const auto& [range, view] : _spanning_views) {
+        usage += sizeof(std::pair<const std::pair<size_t, size_t>, std::string>) + view.capacity();
+    }
+
+    // The window of the last view only counts if nothing else keeps it.
+    if (_last_window && _last_window.use_count() == 1) usage += _last_window->capacity();
+    usage += _last_view.capacity();
+
+    return usage;
+}
+
+const std::shared_ptr<const std::string>& ChunkedFileSource::_window(const size_t number) const {
+    if (const auto it = _window_lookup.find(number); it != _window_lookup.end()) {
+        _windows.splice(_windows.begin(), _windows, it->second);
+        return it->second->data;
+    }
+
+    // A pinned window is still in memory, even if it was evicted, so it is not read a second time.
+    std::shared_ptr<const std::string> data;
+    if (const auto it = _pinned_windows.find(number); it != _pinned_windows.end()) {
+        data = it->second;
+    } else {
+        const auto start = number * _window_size;
+        auto buffer = std::string(std::min(_window_size, _file.size - start), '\0');
+        _file.read(buffer.data(), buffer.size(), start);
+        data = std::make_shared<const std::string>(std::move(buffer));
+    }
+
+    _windows.push_front({ number, std::move(data) });
+    _window_lookup[number] = _windows.begin();
+
+    if (_windows.size() > _max_windows) {
+        _window_lookup.erase(_windows.back().number);
+        _windows.pop_back();
+    }
+
+    return _windows.front().data;
+}
+
+size_t ChunkedFileSource::_window_count() const {
+    return (_file.size + _window_size - 1) / _window_size;
+}
+
+void ChunkedFileSource::_scan_windows(const size_t count) const {
+    // Scanning streams through the file, so it reads into its own buffer instead of evicting the windows in use.
+    std::string buffer;
+    for (auto scanned = _rows_before.size() - 1; scanned < std::min(count, _window_count()); ++scanned) {
+        const auto start = scanned * _window_size;
+        buffer.resize(std::min(_window_size, _file.size - start));
+        _file.read(buffer.data(), buffer.size(), start);
+
+        _rows_before.push_back(_rows_before.back() + count_newlines(buffer));
+    }
+}
+
+void ChunkedFileSource::_scan_to_row(const size_t row) const {
+    while (_rows_before.back() < row && _rows_before.size() <= _window_count()) {
+        _scan_windows(_rows_before.size());
+    }
+}
+
+bool ChunkedFileSource::_contains_row(const size_t row) const {
+    _scan_to_row(row);
+    return row <= _rows_before.back();
+}
+
+size_t ChunkedFileSource::_row(const size_t index) const {
+    const auto number = index / _window_size;
+    _scan_windows(number);
+
+    // The checkpoint gives the rows before the window, only the part of the window up to the index is recounted.
+    const auto window_offset = index - number * _window_size;
+    if (window_offset == 0) return _rows_before[number];
+
+    return _rows_before[number] + count_newlines(std::string_view(*_window(number)).substr(0, window_offset));
+}
+
+size_t ChunkedFileSource::_line_start(const size_t row) const {
+    if (row == 0) return 0;
+
+    // The row starts after the row-th line break, which lies in the last window that has fewer rows before it.
+    const auto it = std::ranges::lower_bound(_rows_before, row);
+    const auto number = static_cast<size_t>(std::distance(_rows_before.begin(), it) - 1);
+    const auto window = std::string_view(*_window(number));
+
+    size_t window_offset = 0;
+    for (auto remaining = row - _rows_before[number]; remaining > 0; --remaining) {
+        window_offset = window.find('\n', window_offset) + 1;
+    }
+
+    return number * _window_size + window_offset;
+}
+
+std::string ChunkedFileSource::_read(const size_t start, const size_t end) const {
+    std::string result;
+    result.reserve(end - start);
+
+    for (auto position = start; position < end;) {
+        const auto number = position / _window_size;
+        const auto window_offset = position - number * _window_size;
+        const auto length = std::min(_window_size - window_offset, end - position);
+
+        result.append(*_window(number), window_offset, length);
+        position += length;
+    }
+
+    return result;
+}
+
+std::string_view ChunkedFileSource::_view(const size_t start, const size_t end) const {
+    if (start == end) return {};
+
+    // Views within a single window point into it. Without a pin, only the window of the last view is kept, so it
+    // outlives its eviction until the next view is taken.
+    const auto number = start / _window_size;
+    if ((end - 1) / _window_size == number) {
+        const auto& data = _pins > 0 ? _pinned_windows.try_emplace(number, _window(number)).first->second : (_last_window = _window(number));
+        return std::string_view(*data).substr(start - number * _window_size, end - start);
+    }
+
+    if (_pins == 0) {
+        _last_view = _read(start, end);
+        return _last_view;
+    }
+
+    const auto [it, inserted] = _spanning_views.try_emplace({ start, end });
+    if (inserted) it->second = _read(start, end);
+
+    return it->second;
+}
+
+std::pair<size_t, size_t> ChunkedFileSource::_line_range(const size_t row) const {
+    const auto start = _line_start(row);
+
+    // Lines may span several windows, so the line break is searched window by window.
+    auto end = _file.size;
+    for (auto position = start; position < _file.size;) {
+        const auto number = position / _window_size;
+        const auto window = std::string_view(*_window(number)).substr(position - number * _window_size);
+
+        if (const auto found = window.find('\n'); found != std::string_view::npos) {
+            end = position + found;
+            break;
+        }
+
+        position += window.size();
+    }
+
+    if (end > start && (*_window((end - 1) / _window_size))[(end - 1) % _window_size] == '\r') --end;
+
+    return { start, end };
+}
+
+std::string ChunkedFileSource::_line(const size_t row) const {
+    const auto [start, end] = _line_range(row);
+    return _read(start, end);
+}
+
+size_t ChunkedFileSource::_to_column(const size_t row, const size_t byte_column, const ColumnUnit unit) const {
+    auto stream = LineStream(*this, _line_start(row));
+
+    size_t column = 0;
+    while (stream.offset < byte_column) {
+        const auto ahead = stream.ahead(STREAM_LOOKAHEAD);
+        if (ahead.empty()) break;
+
+        if (const auto run = unit_run(ahead, byte_column - stream.offset, unit, stream.ended); run > 0) {
+            column += run;
+            stream.offset += run;
+        } else if (unit == ColumnUnit::Visual) {
+            const auto [width, byte_count] = stream.visual_char();
+            column += width;
+            stream.offset += byte_count;
+        } else {
+            const auto [code_point, byte_count] = decode_utf8(ahead, 0);
+            column += code_units(code_point, unit);
+            stream.offset += byte_count;
+        }
+    }
+
+    return column;
+}
+
+size_t ChunkedFileSource::_from_column(const size_t row, const size_t column, const ColumnUnit unit) const {
+    auto stream = LineStream(*this, _line_start(row));
+
+    size_t current_column = 0;
+    while (current_column < column) {
+        const auto ahead = stream.ahead(STREAM_LOOKAHEAD);
+        if (ahead.empty()) break;
+
+        if (const auto run = unit_run(ahead, column - current_column, unit, stream.ended); run > 0) {
+            current_column += run;
+            stream.offset += run;
+            continue;
+        }
+
+        size_t units, byte_count;
+        if (unit == ColumnUnit::Visual) {
+            const auto visual_char = stream.visual_char();
+            units = visual_char.visual_width;
+            byte_count = visual_char.byte_count;
+        } else {
+            const auto decoded = decode_utf8(ahead, 0);
+            units = code_units(decoded.code_point, unit);
+            byte_count = decoded.byte_count;
+        }
+
+        if (current_column + units > column) break;
+
+        current_column += units;
+        stream.offset += byte_count;
+    }
+
+    return stream.offset;
+}
+
+void ChunkedFileSource::_unpin() const {
+    const std::lock_guard lock(_mutex);
+    if (--_pins > 0) return;
+
+    // The table is swapped out instead of cleared, which would keep its buckets.
+    decltype(_pinned_windows)().swap(_pinned_windows);
+    _spanning_views.clear();
+}
+
+ChunkedFileSource::LineStream::LineStream(const ChunkedFileSource& source, const size_t start) :
+    source(source), start(start), buffer_offset(0), offset(0), ended(false) {
+}
+
+// Returns the rest of the line from the offset on, at least `count` bytes of it unless the line ends before.
+// A carriage return at the end of the buffer could still be the end of the line, so it is held back until the next read.
+std::string_view ChunkedFileSource::LineStream::ahead(const size_t count) {
+    while (!ended && buffer_offset + buffer.size() < offset + count + 1) {
+        buffer.erase(0, offset - buffer_offset);
+        buffer_offset = offset;
+
+        const auto position = start + buffer_offset + buffer.size();
+        if (position >= source._file.size) {
+            ended = true;
+        } else {
+            const auto number = position / source._window_size;
+            const auto window = std::string_view(*source._window(number)).substr(position - number * source._window_size);
+
+            const auto found = window.find('\n');
+            buffer.append(window.substr(0, found));
+            ended = found != std::string_view::npos;
+        }
+
+        if (ended && !buffer.empty() && buffer.back() == '\r') buffer.pop_back();
+    }
+
+    auto rest = std::string_view(buffer).substr(offset - buffer_offset);
+    if (!ended && !rest.empty() && rest.back() == '\r') rest.remove_suffix(1);
+
+    return rest;
+}
+
+// Characters can be extended by the ones behind them, so one is only taken once the next character follows it as well.
+VisualChar ChunkedFileSource::LineStream::visual_char() {
+    for (auto count = STREAM_LOOKAHEAD;; count *= 2) {
+        const auto rest = ahead(count);
+        const auto visual_char = get_visual_char(rest, 0);
+        if (ended || visual_char.byte_count + 4 <= rest.size()) return visual_char;
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const ChunkedFileSource& source) {
+    os << "ChunkedFileSource(";
+    os << "path=\"" << source.path() << "\", ";
+    os << "size=\"" << source.size() << "\"";
+    os << ")";
+    return os;
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,130 @@
+#include "pretty_diagnostics/compact_span.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+using namespace pretty_diagnostics;
+
+static_assert(sizeof(CompactSpan) == 12, "compact spans are meant to be embedded in every AST node");
+
+CompactSpan::CompactSpan(const uint32_t source_id, const uint32_t start_index, const uint32_t end_index) :
+    _source_id(source_id), _start_index(start_index), _end_index(end_index) {
+    if (start_index > end_index) {
+        throw std::runtime_error("CompactSpan::CompactSpan(): start index must be smaller than the end index");
+    }
+}
+
+CompactSpan CompactSpan::join(const CompactSpan& other) const {
+    if (_source_id != other._source_id) {
+        throw std::runtime_error("CompactSpan::join(): spans belong to different sources");
+    }
+
+    return { _source_id, std::min(_start_index, other._start_index), std::max(_end_index, other._end_index) };
+}
+
+bool CompactSpan::intersects(const CompactSpan& other) const {
+    return _source_id == other._source_id && _start_index <= other._end_index && _end_index > other._start_index;
+}
+
+uint32_t SourceTable::add(const std::shared_ptr<Source>& source) {
+    {
+        const std::shared_lock lock(_mutex);
+        if (const auto it = _ids.find(source.get()); it != _ids.end()) return it->second;
+    }
+
+    const std::unique_lock lock(_mutex);
+    if (const auto it = _ids.find(source.get()); it != _ids.end()) return it->second;
+
+    if (_sources.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("SourceTable::add(): too many sources registered");
+    }
+
+    const auto source_id = static_cast<uint32_t>(_sources.size());
+    _sources.push_back(source);
+    _ids.emplace(source.get(), source_id);
+
+    return source_id;
+}
+
+const std::shared_ptr<Source>& SourceTable::source(const uint32_t source_id) const {
+    // The deque never moves its elements on insertion, so the reference outlives the lock.
+    const std::shared_lock lock(_mutex);
+    if (source_id >= _sources.size()) {
+        throw std::runtime_error("SourceTable::source(): invalid source id");
+    }
+
+    return _sources[source_id];
+}
+
+std::shared_ptr<Source> SourceTable::borrow(const uint32_t source_id) const {
+    return pretty_diagnostics::borrow(*source(source_id));
+}
+
+CompactSpan SourceTable::compact(const Span& span) {
+    if (span.end().index() > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("SourceTable::compact(): span ends beyond the 32-bit offset range");
+    }
+
+    return { add(span.source()), static_cast<uint32_t>(span.start().index()), static_cast<uint32_t>(span.end().index()) };
+}
+
+Span SourceTable::resolve(const CompactSpan& span) const {
+    return { source(span.source_id()), span.start_index(), span.end_index() };
+}
+
+Span SourceTable::resolve_borrowed(const CompactSpan& span) const {
+    return { borrow(span.source_id()), span.start_index(), span.end_index() };
+}
+
+Location SourceTable::start(const CompactSpan& span) const {
+    return source(span.source_id())->from_index(span.start_index());
+}
+
+Location SourceTable::end(const CompactSpan& span) const {
+    return source(span.source_id())->from_index(span.end_index());
+}
+
+size_t SourceTable::size() const {
+    const std::shared_lock lock(_mutex);
+    return _sources.size();
+}
+
+std::ostream& operator<<(std::ostream& os, const CompactSpan& span) {
+    os << "CompactSpan(";
+    os << "source_id=\"" << span.source_id() << "\", ";
+    os << "start_index=\"" << span.start_index() << "\", ";
+    os << "end_index=\"" << span.end_index() << "\"";
+    os << ")";
+    return os;
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,317 @@
+#include "pretty_diagnostics/editable_source.hpp"
+#include "pretty_diagnostics/line_index.hpp"
+#include "pretty_diagnostics/utils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace pretty_diagnostics;
+
+// Once edits split the contents into more pieces than this, they are merged back into a single buffer
+constexpr size_t MAX_PIECES = 4096;
+
+EditableSource::Buffer::Buffer(std::string text) :
+    text(std::move(text)) {
+    find_line_starts(this->text, 0, line_starts);
+}
+
+size_t EditableSource::Buffer::newlines(const size_t start, const size_t end) const {
+    // A line break at position p is recorded as the line start p + 1.
+    const auto first = std::ranges::upper_bound(line_starts, start);
+    const auto last = std::ranges::upper_bound(line_starts, end);
+    return static_cast<size_t>(std::distance(first, last));
+}
+
+EditableSource::EditableSource(std::string contents, std::string display_path) :
+    _display_path(std::move(display_path)), _piece_starts{ 0 }, _piece_rows{ 0 }, _version(0) {
+    if (contents.empty()) return;
+
+    const auto length = contents.size();
+    _pieces.push_back(_make_piece(std::make_shared<const Buffer>(std::move(contents)), 0, length));
+    _update_prefixes(0);
+}
+
+EditableSource::EditableSource(const EditableSource& other) :
+    _display_path(other._display_path), _pieces(other._pieces), _piece_starts(other._piece_starts), _piece_rows(other._piece_rows),
+    _version(other._version) {
+}
+
+void EditableSource::edit(const size_t start_index, const size_t end_index, const std::string_view replacement) {
+    if (end_index < start_index || end_index > size()) {
+        throw std::runtime_error("EditableSource::edit(): invalid range");
+    }
+
+    if (start_index == end_index && replacement.empty()) return;
+
+    // Pieces [first, last) overlap the edited range, an insertion splits the piece it lands in.
+    const auto first = (start_index == size()) ? _pieces.size() : _piece_at(start_index);
+    const auto last = (end_index > start_index) ? _piece_at(end_index - 1) + 1 : std::min(first + 1, _pieces.size());
+
+    std::vector<Piece> pieces;
+    if (first < _pieces.size()) {
+        const auto& piece = _pieces[first];
+        const auto offset = start_index - _piece_starts[first];
+        if (offset > 0) pieces.push_back(_make_piece(piece.buffer, piece.start, offset));
+    }
+
+    if (!replacement.empty()) {
+        pieces.push_back(_make_piece(std::make_shared<const Buffer>(std::string(replacement)), 0, replacement.size()));
+    }
+
+    if (last > first) {
+        const auto& piece = _pieces[last - 1];
+        const auto offset = end_index - _piece_starts[last - 1];
+        if (offset < piece.length) pieces.push_back(_make_piece(piece.buffer, piece.start + offset, piece.length - offset));
+    }
+
+    _pieces.erase(_pieces.begin() + static_cast<long>(first), _pieces.begin() + static_cast<long>(last));
+    _pieces.insert(_pieces.begin() + static_cast<long>(first), pieces.begin(), pieces.end());
+    _update_prefixes(first);
+
+    if (_pieces.size() > MAX_PIECES) _flatten();
+
+    ++_version;
+    _invalidate_caches();
+}
+
+void EditableSource::edit(const Location& start, const Location& end, const std::string_view replacement) {
+    edit(start.index(), end.index(), replacement);
+}
+
+std::shared_ptr<EditableSource> EditableSource::snapshot() const {
+    return std::shared_ptr<EditableSource>(new EditableSource(*this));
+}
+
+Location EditableSource::from_coords(const size_t row, const size_t column) const {
+    if (row >= line_count()) {
+        throw std::runtime_error("EditableSource::from_coords(): invalid coordinates, there are not enough rows present");
+    }
+
+    const auto line_start = _line_start(row);
+    const auto byte_column = from_visual_column(line_view(row), column);
+
+    return { row, column, line_start + byte_column };
+}
+
+Location EditableSource::from_index(const size_t index) const {
+    if (index > size()) {
+        throw std::runtime_error("EditableSource::from_index(): invalid index, out of bounds");
+    }
+
+    const auto row = _row(index);
+    const auto byte_column = index - _line_start(row);
+    const auto visual_column = to_visual_column(line_view(row), byte_column);
+
+    return { row, visual_column, index };
+}
+
+std::string EditableSource::substr(const Location& start, const Location& end) const {
+    return std::string(EditableSource::substr_view(start, end));
+}
+
+std::string_view EditableSource::substr_view(const Location& start, const Location& end) const {
+    const auto start_index = start.index();
+    const auto end_index = end.index();
+
+    if (end_index < start_index || end_index > size()) {
+        throw std::runtime_error("EditableSource::substr_view(): invalid range");
+    }
+
+    return _view(start_index, end_index);
+}
+
+std::string EditableSource::line(const Location& location) const {
+    return std::string(EditableSource::line_view(location.row()));
+}
+
+std::string EditableSource::line(const size_t line_number) const {
+    return std::string(EditableSource::line_view(line_number));
+}
+
+std::string_view EditableSource::line_view(const Location& location) const {
+    return EditableSource::line_view(location.row());
+}
+
+std::string_view EditableSource::line_view(const size_t line_number) const {
+    if (line_number >= line_count()) {
+        throw std::runtime_error("EditableSource::line_view(): invalid line number, there are not enough lines present");
+    }
+
+    auto result = _view(_line_start(line_number), _line_end(line_number));
+    if (!result.empty() && result.back() == '\r') result.remove_suffix(1);
+
+    return result;
+}
+
+size_t EditableSource::line_count() const {
+    return _piece_rows.back() + 1;
+}
+
+size_t EditableSource::line_start(const size_t line_number) const {
+    if (line_number >= line_count()) {
+        throw std::runtime_error("EditableSource::line_start(): invalid line number, there are not enough lines present");
+    }
+
+    return _line_start(line_number);
+}
+
+const std::string& EditableSource::contents() const {
+    const std::lock_guard lock(_cache_mutex);
+    if (!_contents) _contents = _read(0, size());
+
+    return *_contents;
+}
+
+std::string_view EditableSource::contents_view() const {
+    return contents();
+}
+
+std::string EditableSource::path() const {
+    return _display_path;
+}
+
+size_t EditableSource::size() const {
+    return _piece_starts.back();
+}
+
+EditableSource::Piece EditableSource::_make_piece(const std::shared_ptr<const Buffer>& buffer, const size_t start, const size_t length) {
+    return { buffer, start, length, buffer->newlines(start, start + length) };
+}
+
+void EditableSource::_update_prefixes(const size_t first_piece) {
+    _piece_starts.resize(_pieces.size() + 1);
+    _piece_rows.resize(_pieces.size() + 1);
+
+    for (auto index = first_piece; index < _pieces.size(); ++index) {
+        _piece_starts[index + 1] = _piece_starts[index] + _pieces[index].length;
+        _piece_rows[index + 1] = _piece_rows[index] + _pieces[index].newlines;
+    }
+}
+
+void EditableSource::_flatten() {
+    auto contents = _read(0, size());
+    const auto length = contents.size();
+
+    _pieces.clear();
+    _pieces.push_back(_make_piece(std::make_shared<const Buffer>(std::move(contents)), 0, length));
+    _update_prefixes(0);
+}
+
+void EditableSource::_invalidate_caches() {
+    const std::lock_guard lock(_cache_mutex);
+    _contents.reset();
+    _materialized.clear();
+}
+
+size_t EditableSource::_piece_at(const size_t index) const {
+    const auto it = std::ranges::upper_bound(_piece_starts, index);
+    return static_cast<size_t>(std::distance(_piece_starts.begin(), it) - 1);
+}
+
+size_t EditableSource::_row(const size_t index) const {
+    if (index == size()) return _piece_rows.back();
+
+    const auto piece_index = _piece_at(index);
+    const auto& piece = _pieces[piece_index];
+
+    return _piece_rows[piece_index] + piece.buffer->newlines(piece.start, piece.start + (index - _piece_starts[piece_index]));
+}
+
+size_t EditableSource::_line_start(const size_t row) const {
+    if (row == 0) return 0;
+
+    // The row starts after the row-th line break, which lies in the last piece that has fewer rows before it.
+    const auto it = std::ranges::lower_bound(_piece_rows, row);
+    const auto piece_index = static_cast<size_t>(std::distance(_piece_rows.begin(), it) - 1);
+    const auto& piece = _pieces[piece_index];
+    const auto& line_starts = piece.buffer->line_starts;
+
+    const auto first_in_piece = std::ranges::upper_bound(line_starts, piece.start);
+    const auto buffer_offset = *(first_in_piece + static_cast<long>(row - _piece_rows[piece_index] - 1));
+
+    return _piece_starts[piece_index] + (buffer_offset - piece.start);
+}
+
+size_t EditableSource::_line_end(const size_t row) const {
+    return (row < _piece_rows.back()) ? _line_start(row + 1) - 1 : size();
+}
+
+std::string_view EditableSource::_view(const size_t start, const size_t end) const {
+    if (start == end) return {};
+
+    // Text within a single piece is served straight from its buffer, everything else is assembled once per edit.
+    const auto piece_index = _piece_at(start);
+    if (end <= _piece_starts[piece_index + 1]) {
+        const auto& piece = _pieces[piece_index];
+        return std::string_view(piece.buffer->text).substr(piece.start + (start - _piece_starts[piece_index]), end - start);
+    }
+
+    // A row is copied as a whole and shared by all ranges within it, longer ranges are served from a copy of
+    // the contents. Reads without edits in between therefore never hold more than two copies of the text.
+    const auto row = _row(start);
+    const auto line_end = _line_end(row);
+    if (end > line_end) return contents_view().substr(start, end - start);
+
+    const auto line_start = _line_start(row);
+
+    const std::lock_guard lock(_cache_mutex);
+    const auto [it, inserted] = _materialized.try_emplace(row);
+    if (inserted) it->second = _read(line_start, line_end);
+
+    return std::string_view(it->second).substr(start - line_start, end - start);
+}
+
+std::string EditableSource::_read(const size_t start, const size_t end) const {
+    std::string result;
+    result.reserve(end - start);
+
+    for (auto position = start; position < end;) {
+        const auto piece_index = _piece_at(position);
+        const auto& piece = _pieces[piece_index];
+        const auto offset = position - _piece_starts[piece_index];
+        const auto length = std::min(piece.length - offset, end - position);
+
+        result.append(piece.buffer->text, piece.start + offset, length);
+        position += length;
+    }
+
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& os, const EditableSource& source) {
+    os << "EditableSource(";
+    os << "path=\"" << source.path() << "\", ";
+    os << "version=\"" << source.version() << "\", ";
+    os << "size=\"" << source.size() << "\"";
+    os << ")";
+    return os;
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
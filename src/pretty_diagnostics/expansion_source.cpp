@@ -0,0 +1,151 @@
+#include "pretty_diagnostics/expansion_source.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace pretty_diagnostics;
+
+// Layers of expansion that are followed at most, so a source that maps into itself can't loop forever
+constexpr size_t MAX_EXPANSION_DEPTH = 256;
+
+ExpansionSource::ExpansionSource(std::string contents, std::string display_path, const IndexConfig& config) :
+    StringSource(std::move(contents), std::move(display_path), config) {
+}
+
+void ExpansionSource::map(const size_t start, const size_t end, std::shared_ptr<Source> parent, const size_t parent_start, const size_t parent_end) {
+    if (!parent) {
+        throw std::runtime_error("ExpansionSource::map(): the parent source must not be null");
+    }
+
+    if (end < start || end > size()) {
+        throw std::runtime_error("ExpansionSource::map(): invalid range");
+    }
+
+    if (parent_end < parent_start || parent_end > parent->size()) {
+        throw std::runtime_error("ExpansionSource::map(): invalid parent range");
+    }
+
+    if (!_mappings.empty() && start < _mappings.back().end) {
+        throw std::runtime_error("ExpansionSource::map(): ranges have to be mapped in ascending order without overlapping");
+    }
+
+    const auto [it, inserted] = _parent_ids.try_emplace(parent.get(), static_cast<uint32_t>(_parents.size()));
+    if (inserted) {
+        if (_parents.size() == std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("ExpansionSource::map(): there are too many parent sources");
+        }
+
+        _parents.push_back(std::move(parent));
+    }
+
+    _mappings.push_back({ start, end, parent_start, parent_end, it->second });
+}
+
+std::optional<ExpansionRange> ExpansionSource::find(const size_t index) const {
+    const auto* mapping = _find(index);
+    if (!mapping) return std::nullopt;
+
+    return ExpansionRange{ mapping->start, mapping->end, _parents[mapping->parent], mapping->parent_start, mapping->parent_end };
+}
+
+std::optional<Span> ExpansionSource::to_parent(const Span& span) const {
+    if (span.source().get() != this) {
+        throw std::runtime_error("ExpansionSource::to_parent(): the span belongs to another source");
+    }
+
+    const auto start = span.start().index(), end = span.end().index();
+
+    const auto* first = _find(start);
+    if (!first) return std::nullopt;
+
+    const auto parent_start = _to_parent(*first, start, false);
+    auto parent_end = _to_parent(*first, std::min(end, first->end), true);
+
+    // The span ends in a later mapping, which is only followed if it points further into the same parent.
+    if (const auto* last = end > first->end ? _find(end - 1) : nullptr; last && last->parent == first->parent) {
+        parent_end = std::max(parent_end, _to_parent(*last, end, true));
+    }
+
+    return Span(_parents[first->parent], parent_start, parent_end);
+}
+
+const ExpansionSource::Mapping* ExpansionSource::_find(const size_t index) const {
+    const auto it = std::ranges::upper_bound(_mappings, index, {}, &Mapping::start);
+    if (it == _mappings.begin()) return nullptr;
+
+    const auto& mapping = *std::prev(it);
+    // An empty mapping still maps the position it sits at, e.g. a macro that expanded to nothing.
+    if (index < mapping.end || (mapping.start == mapping.end && index == mapping.start)) return &mapping;
+
+    return nullptr;
+}
+
+size_t ExpansionSource::_to_parent(const Mapping& mapping, const size_t index, const bool is_end) {
+    const auto copied = mapping.end - mapping.start == mapping.parent_end - mapping.parent_start;
+    if (copied) return mapping.parent_start + (index - mapping.start);
+
+    return is_end ? mapping.parent_end : mapping.parent_start;
+}
+
+std::vector<Span> pretty_diagnostics::expansion_chain(const Span& span) {
+    std::vector<Span> chain;
+
+    const auto* current = &span;
+    while (chain.size() < MAX_EXPANSION_DEPTH) {
+        const auto* expansion = dynamic_cast<const ExpansionSource*>(current->source().get());
+        if (!expansion) break;
+
+        auto parent_span = expansion->to_parent(*current);
+        if (!parent_span) break;
+
+        chain.push_back(std::move(*parent_span));
+        current = &chain.back();
+    }
+
+    return chain;
+}
+
+Span pretty_diagnostics::spelling_span(const Span& span) {
+    auto chain = expansion_chain(span);
+    return chain.empty() ? span : std::move(chain.back());
+}
+
+std::ostream& operator<<(std::ostream& os, const ExpansionSource& source) {
+    os << "ExpansionSource(";
+    os << "path=\"" << source.path() << "\", ";
+    os << "size=\"" << source.size() << "\", ";
+    os << "mappings=\"" << source.mapping_count() << "\"";
+    os << ")";
+    return os;
+}
+
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,250 @@
+#include "pretty_diagnostics/index_cache.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+using namespace pretty_diagnostics;
+
+constexpr std::array<char, 8> CACHE_MAGIC = { 'P', 'D', 'L', 'I', 'N', 'E', 'S', '2' };
+
+// Written in the byte order of the machine, entries from a machine with a different one are rejected.
+constexpr uint64_t CACHE_BYTE_ORDER = 0x0102030405060708;
+
+struct CacheHeader {
+    std::array<char, 8> magic;
+    uint64_t byte_order;
+    uint64_t file_size;
+    int64_t modified;
+    uint64_t path_length;
+    uint64_t line_count;
+};
+
+struct FileKey {
+    std::string path;
+    uint64_t size;
+    int64_t modified;
+};
+
+static size_t align_to_words(const size_t size) {
+    return (size + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+}
+
+static std::optional<FileKey> make_key(const std::filesystem::path& path, const FileStamp& stamp) {
+    std::error_code error;
+
+    auto canonical_path = std::filesystem::weakly_canonical(path, error);
+    if (error) return std::nullopt;
+
+    return FileKey{ canonical_path.string(), stamp.size, stamp.modified };
+}
+
+static uint64_t hash_path(const std::string_view path) {
+    // FNV-1a, entry names have to stay the same across runs and standard library implementations.
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const auto character : path) {
+        hash ^= static_cast<uint8_t>(character);
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
+static std::filesystem::path entry_name(const std::string_view canonical_path) {
+    constexpr auto digits = "0123456789abcdef";
+
+    std::string name(16, '0');
+    auto hash = hash_path(canonical_path);
+    for (auto it = name.rbegin(); it != name.rend(); ++it, hash >>= 4) *it = digits[hash & 0xF];
+
+    return name + ".lines";
+}
+
+std::optional<FileStamp> pretty_diagnostics::stamp_file(const std::filesystem::path& path) {
+    std::error_code error;
+
+    const auto size = std::filesystem::file_size(path, error);
+    if (error) return std::nullopt;
+
+    const auto modified = std::filesystem::last_write_time(path, error);
+    if (error) return std::nullopt;
+
+    const auto since_epoch = std::chrono::file_clock::to_sys(modified).time_since_epoch();
+    return FileStamp{ size, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count()) };
+}
+
+#ifndef _WIN32
+FileStamp pretty_diagnostics::stamp_file(const struct ::stat& file_stat) {
+#ifdef __APPLE__
+    const auto& modified = file_stat.st_mtimespec;
+#else
+    const auto& modified = file_stat.st_mtim;
+#endif
+
+    return { static_cast<uint64_t>(file_stat.st_size), static_cast<int64_t>(modified.tv_sec) * 1'000'000'000 + modified.tv_nsec };
+}
+#endif
+
+IndexCache::IndexCache(std::filesystem::path directory) :
+    _directory(std::move(directory)) {
+}
+
+std::optional<IndexData> IndexCache::load(const std::filesystem::path& path) const {
+    const auto stamp = stamp_file(path);
+    return stamp ? load(path, *stamp) : std::nullopt;
+}
+
+std::optional<IndexData> IndexCache::load(const std::filesystem::path& path, const FileStamp& stamp) const {
+    const auto key = make_key(path, stamp);
+    if (!key) return std::nullopt;
+
+    std::ifstream stream(_directory / entry_name(key->path), std::ios::binary);
+    if (!stream.is_open()) return std::nullopt;
+
+    CacheHeader header{};
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))) return std::nullopt;
+
+    if (header.magic != CACHE_MAGIC || header.byte_order != CACHE_BYTE_ORDER) return std::nullopt;
+    if (header.file_size != key->size || header.modified != key->modified) return std::nullopt;
+    if (header.path_length != key->path.size() || header.line_count == 0 || header.line_count > key->size + 1) return std::nullopt;
+
+    // Different paths can hash to the same entry, so the entry has to name the same file.
+    std::string entry_path(align_to_words(header.path_length), '\0');
+    if (!stream.read(entry_path.data(), static_cast<std::streamsize>(entry_path.size()))) return std::nullopt;
+    if (std::string_view(entry_path).substr(0, header.path_length) != key->path) return std::nullopt;
+
+    IndexData data;
+    data.line_starts.resize(header.line_count);
+
+    static_assert(sizeof(size_t) == sizeof(uint64_t), "the cache stores line starts as 64-bit offsets");
+    const auto line_starts_size = static_cast<std::streamsize>(header.line_count * sizeof(uint64_t));
+    if (!stream.read(reinterpret_cast<char*>(data.line_starts.data()), line_starts_size)) return std::nullopt;
+
+    std::vector<uint64_t> words((header.line_count + 63) / 64);
+    const auto words_size = static_cast<std::streamsize>(words.size() * sizeof(uint64_t));
+    if (!stream.read(reinterpret_cast<char*>(words.data()), words_size)) return std::nullopt;
+
+    data.non_ascii.resize(header.line_count);
+    for (size_t row = 0; row < header.line_count; ++row) {
+        data.non_ascii[row] = (words[row / 64] >> (row % 64)) & 1;
+    }
+
+    return data;
+}
+
+bool IndexCache::store(const std::filesystem::path& path, const LineIndex& index) const {
+    const auto stamp = stamp_file(path);
+    return stamp && store(path, index, *stamp);
+}
+
+bool IndexCache::store(const std::filesystem::path& path, const LineIndex& index, const FileStamp& stamp) const {
+    const auto key = make_key(path, stamp);
+    if (!key || key->size != index.contents().size()) return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+    if (error) return false;
+
+    const auto data = index.data();
+
+    std::vector<uint64_t> words((data.non_ascii.size() + 63) / 64);
+    for (size_t row = 0; row < data.non_ascii.size(); ++row) {
+        if (data.non_ascii[row]) words[row / 64] |= uint64_t{ 1 } << (row % 64);
+    }
+
+    const auto header = CacheHeader{
+        .magic = CACHE_MAGIC,
+        .byte_order = CACHE_BYTE_ORDER,
+        .file_size = key->size,
+        .modified = key->modified,
+        .path_length = key->path.size(),
+        .line_count = data.line_starts.size(),
+    };
+
+    auto entry_path = key->path;
+    entry_path.resize(align_to_words(entry_path.size()), '\0');
+
+    // Written under a unique name first, so readers either see the old or the new entry as a whole.
+    const auto target = _directory / entry_name(key->path);
+    auto temporary = target;
+    temporary += "." + std::to_string(std::random_device()()) + ".tmp";
+
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(entry_path.data(), static_cast<std::streamsize>(entry_path.size()));
+        stream.write(reinterpret_cast<const char*>(data.line_starts.data()), static_cast<std::streamsize>(data.line_starts.size() * sizeof(uint64_t)));
+        stream.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint64_t)));
+
+        if (!stream.flush()) {
+            stream.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary, target, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    return true;
+}
+
+std::filesystem::path IndexCache::entry_path(const std::filesystem::path& path) const {
+    std::error_code error;
+    const auto canonical_path = std::filesystem::weakly_canonical(path, error);
+
+    return _directory / entry_name(error ? path.string() : canonical_path.string());
+}
+
+LineIndex pretty_diagnostics::load_line_index(const std::string_view contents, const std::filesystem::path& path, const FileStamp& stamp,
+                                              const IndexConfig& config) {
+    auto data = config.cache_directory.empty() ? std::nullopt : IndexCache(config.cache_directory).load(path, stamp);
+    return data ? LineIndex(contents, std::move(*data), config) : LineIndex(contents, config);
+}
+
+void pretty_diagnostics::store_line_index(const std::filesystem::path& path, const LineIndex& index, const FileStamp& stamp,
+                                          const IndexConfig& config) {
+    if (config.cache_directory.empty() || config.mode != IndexMode::Eager || index.is_restored()) return;
+
+    (void) IndexCache(config.cache_directory).store(path, index, stamp);
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
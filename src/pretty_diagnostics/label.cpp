@@ -2,8 +2,16 @@
 
 using namespace pretty_diagnostics;
 
-Label::Label(std::string text, Span span) :
-    _text(std::move(text)), _span(std::move(span)) {
+Label::Label(const std::string_view text, Span span, const allocator_type& allocator) :
+    _text(text, allocator), _span(std::move(span)) {
+}
+
+Label::Label(const Label& other, const allocator_type& allocator) :
+    _text(other._text, allocator), _span(other._span) {
+}
+
+Label::Label(Label&& other, const allocator_type& allocator) :
+    _text(std::move(other._text), allocator), _span(std::move(other._span)) {
 }
 
 // BSD 3-Clause License
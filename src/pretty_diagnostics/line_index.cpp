@@ -0,0 +1,733 @@
+#include "pretty_diagnostics/line_index.hpp"
+#include "pretty_diagnostics/utils.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PRETTY_DIAGNOSTICS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace pretty_diagnostics;
+
+// Lazy scans never advance by less than this many bytes to amortize the locking
+constexpr size_t LAZY_SCAN_CHUNK = 64 * 1024;
+// Distance in bytes between two checkpoints of a column table, shorter rows are decoded directly
+constexpr size_t COLUMN_CHECKPOINT_INTERVAL = 64;
+// Number of line starts per block of the compact encoding, every block begins with an absolute offset
+constexpr size_t COMPACT_BLOCK_SIZE = 64;
+
+static size_t count_newlines_portable(const char* data, const size_t size) {
+    return static_cast<size_t>(std::count(data, data + size, '\n'));
+}
+
+static void write_line_starts_portable(const char* data, const size_t size, const size_t offset, size_t* output) {
+    const auto* current = data;
+    const auto* end = data + size;
+
+    while (current < end) {
+        const auto* found = static_cast<const char*>(std::memchr(current, '\n', end - current));
+        if (found == nullptr) break;
+
+        *output++ = offset + (found - data) + 1;
+        current = found + 1;
+    }
+}
+
+#ifdef PRETTY_DIAGNOSTICS_X86_KERNELS
+__attribute__((target("sse2"))) static size_t count_newlines_sse2(const char* data, const size_t size) {
+    const auto newline = _mm_set1_epi8('\n');
+    const auto vector_end = size - size % 16;
+
+    size_t count = 0, index = 0;
+    while (index < vector_end) {
+        // Every byte lane counts matches up to 255 times before the lanes are summed up, so it never overflows.
+        const auto block_end = std::min(vector_end, index + 255 * 16);
+
+        auto counters = _mm_setzero_si128();
+        for (; index < block_end; index += 16) {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+            counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(chunk, newline));
+        }
+
+        const auto sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+        count += static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+    }
+
+    return count + count_newlines_portable(data + index, size - index);
+}
+
+__attribute__((target("sse2"))) static void write_line_starts_sse2(const char* data, const size_t size, const size_t offset, size_t* output) {
+    const auto newline = _mm_set1_epi8('\n');
+    const auto vector_end = size - size % 16;
+
+    size_t index = 0;
+    for (; index < vector_end; index += 16) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+
+        while (mask != 0) {
+            *output++ = offset + index + std::countr_zero(mask) + 1;
+            mask &= mask - 1;
+        }
+    }
+
+    write_line_starts_portable(data + index, size - index, offset + index, output);
+}
+
+__attribute__((target("avx2"))) static size_t count_newlines_avx2(const char* data, const size_t size) {
+    const auto newline = _mm256_set1_epi8('\n');
+    const auto vector_end = size - size % 32;
+
+    size_t count = 0, index = 0;
+    while (index < vector_end) {
+        // Every byte lane counts matches up to 255 times before the lanes are summed up, so it never overflows.
+        const auto block_end = std::min(vector_end, index + 255 * 32);
+
+        auto counters = _mm256_setzero_si256();
+        for (; index < block_end; index += 32) {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+            counters = _mm256_sub_epi8(counters, _mm256_cmpeq_epi8(chunk, newline));
+        }
+
+        alignas(32) uint64_t sums[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_sad_epu8(counters, _mm256_setzero_si256()));
+        count += sums[0] + sums[1] + sums[2] + sums[3];
+    }
+
+    return count + count_newlines_portable(data + index, size - index);
+}
+
+__attribute__((target("avx2"))) static void write_line_starts_avx2(const char* data, const size_t size, const size_t offset, size_t* output) {
+    const auto newline = _mm256_set1_epi8('\n');
+    const auto vector_end = size - size % 32;
+
+    size_t index = 0;
+    for (; index < vector_end; index += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+
+        while (mask != 0) {
+            *output++ = offset + index + std::countr_zero(mask) + 1;
+            mask &= mask - 1;
+        }
+    }
+
+    write_line_starts_portable(data + index, size - index, offset + index, output);
+}
+#endif
+
+static ScanKernel resolve_kernel(const ScanKernel kernel) {
+    if (kernel != ScanKernel::Auto) return kernel;
+
+    static const auto fastest = is_kernel_supported(ScanKernel::AVX2)   ? ScanKernel::AVX2
+                                : is_kernel_supported(ScanKernel::SSE2) ? ScanKernel::SSE2
+                                                                        : ScanKernel::Portable;
+    return fastest;
+}
+
+bool pretty_diagnostics::is_kernel_supported(const ScanKernel kernel) {
+    switch (kernel) {
+#ifdef PRETTY_DIAGNOSTICS_X86_KERNELS
+        case ScanKernel::SSE2: return __builtin_cpu_supports("sse2");
+        case ScanKernel::AVX2: return __builtin_cpu_supports("avx2");
+#else
+        case ScanKernel::SSE2:
+        case ScanKernel::AVX2: return false;
+#endif
+        case ScanKernel::Auto:
+        case ScanKernel::Portable:
+        default: return true;
+    }
+}
+
+size_t pretty_diagnostics::count_newlines(const std::string_view input, const ScanKernel kernel) {
+    if (!is_kernel_supported(kernel)) {
+        throw std::runtime_error("count_newlines(): the requested kernel is not supported");
+    }
+
+    switch (resolve_kernel(kernel)) {
+#ifdef PRETTY_DIAGNOSTICS_X86_KERNELS
+        case ScanKernel::SSE2: return count_newlines_sse2(input.data(), input.size());
+        case ScanKernel::AVX2: return count_newlines_avx2(input.data(), input.size());
+#endif
+        default: return count_newlines_portable(input.data(), input.size());
+    }
+}
+
+static void write_line_starts(const std::string_view input, const size_t offset, size_t* output, const ScanKernel kernel) {
+    switch (kernel) {
+#ifdef PRETTY_DIAGNOSTICS_X86_KERNELS
+        case ScanKernel::SSE2: return write_line_starts_sse2(input.data(), input.size(), offset, output);
+        case ScanKernel::AVX2: return write_line_starts_avx2(input.data(), input.size(), offset, output);
+#endif
+        default: return write_line_starts_portable(input.data(), input.size(), offset, output);
+    }
+}
+
+void pretty_diagnostics::find_line_starts(const std::string_view input, const size_t offset, std::vector<size_t>& line_starts, const ScanKernel kernel) {
+    if (!is_kernel_supported(kernel)) {
+        throw std::runtime_error("find_line_starts(): the requested kernel is not supported");
+    }
+
+    const auto resolved = resolve_kernel(kernel);
+
+    // A cheap counting pass first, so the vector grows exactly once and the kernels can write without bounds checks.
+    const auto previous_size = line_starts.size();
+    line_starts.resize(previous_size + count_newlines(input, resolved));
+
+    write_line_starts(input, offset, line_starts.data() + previous_size, resolved);
+}
+
+static void find_line_starts_parallel(const std::string_view input, const size_t offset, std::vector<size_t>& line_starts, const size_t workers) {
+    const auto kernel = resolve_kernel(ScanKernel::Auto);
+    const auto chunk_size = (input.size() + workers - 1) / workers;
+    const auto chunk = [&](const size_t worker) { return input.substr(std::min(input.size(), worker * chunk_size), chunk_size); };
+
+    // First every worker counts the line breaks of its chunk...
+    std::vector<size_t> counts(workers);
+    {
+        std::vector<std::jthread> threads;
+        for (size_t worker = 0; worker < workers; ++worker) {
+            threads.emplace_back([&, worker] { counts[worker] = count_newlines(chunk(worker), kernel); });
+        }
+    }
+
+    // ...then a prefix sum over the counts tells every worker where its line starts go...
+    const auto previous_size = line_starts.size();
+    std::vector<size_t> positions(workers);
+    std::exclusive_scan(counts.begin(), counts.end(), positions.begin(), previous_size);
+    line_starts.resize(positions.back() + counts.back());
+
+    // ...so they can all write into the final table at the same time.
+    {
+        std::vector<std::jthread> threads;
+        for (size_t worker = 0; worker < workers; ++worker) {
+            threads.emplace_back([&, worker] {
+                write_line_starts(chunk(worker), offset + worker * chunk_size, line_starts.data() + positions[worker], kernel);
+            });
+        }
+    }
+}
+
+static void write_varint(std::vector<uint8_t>& output, size_t value) {
+    while (value >= 0x80) {
+        output.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    output.push_back(static_cast<uint8_t>(value));
+}
+
+static size_t read_varint(const uint8_t*& input) {
+    size_t value = 0;
+    for (size_t shift = 0;; shift += 7) {
+        const auto byte = *input++;
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return value;
+    }
+}
+
+LineStartTable::LineStartTable(const IndexEncoding encoding) :
+    _compact_size(0), _last(0), _encoding(encoding) {
+    if (encoding == IndexEncoding::Auto) {
+        throw std::runtime_error("LineStartTable::LineStartTable(): the encoding has to be resolved first");
+    }
+}
+
+void LineStartTable::append(const std::span<const size_t> line_starts) {
+    if (_encoding == IndexEncoding::Wide) {
+        _wide.insert(_wide.end(), line_starts.begin(), line_starts.end());
+        return;
+    }
+
+    if (_encoding == IndexEncoding::Narrow) {
+        if (!line_starts.empty() && line_starts.back() > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("LineStartTable::append(): offset too large for the narrow encoding");
+        }
+
+        _narrow.reserve(_narrow.size() + line_starts.size());
+        for (const auto line_start : line_starts) _narrow.push_back(static_cast<uint32_t>(line_start));
+        return;
+    }
+
+    for (const auto line_start : line_starts) {
+        if (_compact_size % COMPACT_BLOCK_SIZE == 0) {
+            _samples.push_back(line_start);
+            _block_offsets.push_back(_deltas.size());
+        } else {
+            write_varint(_deltas, line_start - _last);
+        }
+
+        _last = line_start;
+        ++_compact_size;
+    }
+}
+
+size_t LineStartTable::operator[](const size_t position) const {
+    switch (_encoding) {
+        case IndexEncoding::Wide: return _wide[position];
+        case IndexEncoding::Narrow: return _narrow[position];
+        default: return _compact_at(position);
+    }
+}
+
+size_t LineStartTable::find(const size_t offset) const {
+    const auto search = [offset](const auto& line_starts) {
+        const auto it = std::ranges::upper_bound(line_starts, offset);
+        return static_cast<size_t>(std::distance(line_starts.begin(), it) - 1);
+    };
+
+    switch (_encoding) {
+        case IndexEncoding::Wide: return search(_wide);
+        case IndexEncoding::Narrow: return search(_narrow);
+        default: return _compact_find(offset);
+    }
+}
+
+void LineStartTable::shrink_to_fit() {
+    _wide.shrink_to_fit();
+    _narrow.shrink_to_fit();
+    _samples.shrink_to_fit();
+    _block_offsets.shrink_to_fit();
+    _deltas.shrink_to_fit();
+}
+
+size_t LineStartTable::memory_usage() const {
+    return _wide.capacity() * sizeof(size_t) + _narrow.capacity() * sizeof(uint32_t)
+           + (_samples.capacity() + _block_offsets.capacity()) * sizeof(size_t) + _deltas.capacity();
+}
+
+size_t LineStartTable::size() const {
+    switch (_encoding) {
+        case IndexEncoding::Wide: return _wide.size();
+        case IndexEncoding::Narrow: return _narrow.size();
+        default: return _compact_size;
+    }
+}
+
+size_t LineStartTable::_compact_find(const size_t offset) const {
+    // The samples narrow the search down to a single block, which is then decoded until the offset is passed.
+    const auto block = static_cast<size_t>(std::distance(_samples.begin(), std::ranges::upper_bound(_samples, offset)) - 1);
+    const auto block_end = std::min(_compact_size, (block + 1) * COMPACT_BLOCK_SIZE);
+    const auto* deltas = _deltas.data() + _block_offsets[block];
+
+    auto position = block * COMPACT_BLOCK_SIZE;
+    for (auto line_start = _samples[block]; position + 1 < block_end; ++position) {
+        line_start += read_varint(deltas);
+        if (line_start > offset) break;
+    }
+
+    return position;
+}
+
+size_t LineStartTable::_compact_at(const size_t position) const {
+    const auto block = position / COMPACT_BLOCK_SIZE;
+    const auto* deltas = _deltas.data() + _block_offsets[block];
+
+    auto line_start = _samples[block];
+    for (size_t index = 0; index < position % COMPACT_BLOCK_SIZE; ++index) {
+        line_start += read_varint(deltas);
+    }
+
+    return line_start;
+}
+
+static IndexEncoding resolve_encoding(const IndexEncoding encoding, const size_t size) {
+    const auto fits_narrow = size <= std::numeric_limits<uint32_t>::max();
+    if (encoding == IndexEncoding::Auto) return fits_narrow ? IndexEncoding::Narrow : IndexEncoding::Wide;
+
+    if (encoding == IndexEncoding::Narrow && !fits_narrow) {
+        throw std::runtime_error("LineIndex::LineIndex(): contents too large for the narrow encoding");
+    }
+
+    return encoding;
+}
+
+LineIndex::LineIndex(const std::string_view contents, const IndexConfig& config) :
+    _line_starts(resolve_encoding(config.encoding, contents.size())),
+    _threads(config.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : config.threads),
+    _parallel_threshold(config.parallel_threshold), _complete(false), _scanned(0), _contents(contents), _restored(false) {
+    constexpr size_t first_line_start = 0;
+    _line_starts.append({ &first_line_start, 1 });
+
+    if (config.mode == IndexMode::Eager) {
+        _scan(_contents.size());
+    }
+}
+
+LineIndex::LineIndex(const std::string_view contents, IndexData data, const IndexConfig& config) :
+    LineIndex(contents, IndexConfig{ .mode = IndexMode::Lazy, .threads = config.threads, .parallel_threshold = config.parallel_threshold,
+                                     .encoding = config.encoding }) {
+    if (!_fits(data)) {
+        if (config.mode == IndexMode::Eager) _scan(_contents.size());
+        return;
+    }
+
+    _line_starts.append(std::span(data.line_starts).subspan(1));
+    _line_starts.shrink_to_fit();
+    _non_ascii = std::move(data.non_ascii);
+
+    _scanned = _contents.size();
+    _restored = true;
+    _complete.store(true, std::memory_order_release);
+}
+
+LineIndex::LineIndex(const LineIndex& other) :
+    _line_starts(other.encoding()), _threads(other._threads), _parallel_threshold(other._parallel_threshold), _complete(false),
+    _scanned(0), _contents(other._contents), _restored(other._restored) {
+    *this = other;
+}
+
+LineIndex::LineIndex(LineIndex&& other) noexcept :
+    _column_tables(std::move(other._column_tables)), _line_starts(std::move(other._line_starts)), _non_ascii(std::move(other._non_ascii)),
+    _threads(other._threads), _parallel_threshold(other._parallel_threshold), _complete(other._complete.load(std::memory_order_acquire)),
+    _scanned(other._scanned), _contents(other._contents), _restored(other._restored) {
+}
+
+LineIndex& LineIndex::operator=(const LineIndex& other) {
+    if (this == &other) return *this;
+
+    // The other index may still be scanning lazily, so its state is only read under its own locks.
+    {
+        const std::shared_lock lock(other._mutex);
+        _line_starts = other._line_starts;
+        _non_ascii = other._non_ascii;
+        _scanned = other._scanned;
+        _complete.store(other._complete.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    {
+        const std::shared_lock lock(other._column_mutex);
+        _column_tables = other._column_tables;
+    }
+
+    _threads = other._threads;
+    _parallel_threshold = other._parallel_threshold;
+    _contents = other._contents;
+    _restored = other._restored;
+
+    return *this;
+}
+
+LineIndex& LineIndex::operator=(LineIndex&& other) noexcept {
+    if (this == &other) return *this;
+
+    _column_tables = std::move(other._column_tables);
+    _line_starts = std::move(other._line_starts);
+    _non_ascii = std::move(other._non_ascii);
+    _threads = other._threads;
+    _parallel_threshold = other._parallel_threshold;
+    _complete.store(other._complete.load(std::memory_order_acquire), std::memory_order_release);
+    _scanned = other._scanned;
+    _contents = other._contents;
+    _restored = other._restored;
+
+    return *this;
+}
+
+void LineIndex::rebind(const std::string_view contents) {
+    if (contents.size() != _contents.size()) {
+        throw std::runtime_error("LineIndex::rebind(): the contents differ in size from the indexed ones");
+    }
+
+    _contents = contents;
+}
+
+size_t LineIndex::row(const size_t index) const {
+    if (index > _contents.size()) {
+        throw std::runtime_error("LineIndex::row(): invalid index, out of bounds");
+    }
+
+    // Every line start up to and including the index is known once the bytes before it were scanned.
+    _scan_to_offset(index);
+
+    const auto lock = _read_lock();
+    return _line_starts.find(index);
+}
+
+size_t LineIndex::line_start(const size_t row) const {
+    _scan_to_row(row);
+
+    const auto lock = _read_lock();
+    if (row >= _line_starts.size()) {
+        throw std::runtime_error("LineIndex::line_start(): invalid row, there are not enough rows present");
+    }
+
+    return _line_starts[row];
+}
+
+std::string_view LineIndex::line(const size_t row) const {
+    _scan_to_row(row);
+
+    const auto lock = _read_lock();
+    if (row >= _line_starts.size()) {
+        throw std::runtime_error("LineIndex::line(): invalid row, there are not enough rows present");
+    }
+
+    const auto line_start = _line_starts[row];
+    const auto line_end = (row + 1 < _line_starts.size()) ? _line_starts[row + 1] : _contents.size();
+
+    auto result = _contents.substr(line_start, line_end - line_start);
+    if (!result.empty() && result.back() == '\n') result.remove_suffix(1);
+    if (!result.empty() && result.back() == '\r') result.remove_suffix(1);
+
+    return result;
+}
+
+bool LineIndex::is_ascii(const size_t row) const {
+    _scan_to_row(row);
+
+    const auto lock = _read_lock();
+    if (row >= _line_starts.size()) {
+        throw std::runtime_error("LineIndex::is_ascii(): invalid row, there are not enough rows present");
+    }
+
+    return !_non_ascii[row];
+}
+
+size_t LineIndex::to_visual_column(const size_t row, const size_t byte_column) const {
+    return to_column(row, byte_column, ColumnUnit::Visual);
+}
+
+size_t LineIndex::from_visual_column(const size_t row, const size_t visual_column) const {
+    return from_column(row, visual_column, ColumnUnit::Visual);
+}
+
+size_t LineIndex::to_column(const size_t row, const size_t byte_column, const ColumnUnit unit) const {
+    const auto line = this->line(row);
+    if (is_ascii(row)) return std::min(byte_column, line.size());
+
+    const auto* table = _column_table(row, line);
+    if (table == nullptr) return pretty_diagnostics::to_column(line, byte_column, unit);
+
+    // Continue decoding from the last checkpoint at or before the byte column.
+    const auto it = std::ranges::upper_bound(*table, byte_column, {}, [](const ColumnCheckpoint& checkpoint) { return checkpoint[ColumnUnit::Byte]; });
+    const auto& checkpoint = *std::prev(it);
+    const auto checkpoint_byte = checkpoint[ColumnUnit::Byte];
+
+    return checkpoint[unit] + pretty_diagnostics::to_column(line.substr(checkpoint_byte), byte_column - checkpoint_byte, unit);
+}
+
+size_t LineIndex::from_column(const size_t row, const size_t column, const ColumnUnit unit) const {
+    const auto line = this->line(row);
+    if (is_ascii(row)) return std::min(column, line.size());
+
+    const auto* table = _column_table(row, line);
+    if (table == nullptr) return pretty_diagnostics::from_column(line, column, unit);
+
+    // Continue decoding from the last checkpoint strictly before the column, so zero-width characters
+    // directly at the target are resolved the same way as a scan from the start of the row would.
+    const auto it = std::ranges::lower_bound(*table, column, {}, [unit](const ColumnCheckpoint& checkpoint) { return checkpoint[unit]; });
+    const auto& checkpoint = (it == table->begin()) ? table->front() : *std::prev(it);
+    const auto checkpoint_byte = checkpoint[ColumnUnit::Byte];
+
+    return checkpoint_byte + pretty_diagnostics::from_column(line.substr(checkpoint_byte), column - checkpoint[unit], unit);
+}
+
+size_t LineIndex::convert_column(const size_t row, const size_t column, const ColumnUnit from, const ColumnUnit to) const {
+    return to_column(row, from_column(row, column, from), to);
+}
+
+bool LineIndex::contains_row(const size_t row) const {
+    _scan_to_row(row);
+
+    const auto lock = _read_lock();
+    return row < _line_starts.size();
+}
+
+size_t LineIndex::line_count() const {
+    _scan_to_offset(_contents.size());
+
+    const auto lock = _read_lock();
+    return _line_starts.size();
+}
+
+size_t LineIndex::memory_usage() const {
+    const auto lock = _read_lock();
+    auto usage = _line_starts.memory_usage() + _non_ascii.capacity() / CHAR_BIT;
+
+    const std::shared_lock column_lock(_column_mutex);
+    usage += _column_tables.bucket_count() * sizeof(void*);
+    for (const auto& [row, table] : _column_tables) {
+        usage += sizeof(std::pair<const size_t, ColumnTable>) + table.capacity() * sizeof(ColumnCheckpoint);
+    }
+
+    return usage;
+}
+
+IndexData LineIndex::data() const {
+    _scan_to_offset(_contents.size());
+
+    IndexData data;
+    data.line_starts.resize(_line_starts.size());
+    for (size_t row = 0; row < data.line_starts.size(); ++row) data.line_starts[row] = _line_starts[row];
+    data.non_ascii = _non_ascii;
+
+    return data;
+}
+
+const LineIndex::ColumnTable* LineIndex::_column_table(const size_t row, const std::string_view line) const {
+    if (line.size() < COLUMN_CHECKPOINT_INTERVAL) return nullptr;
+
+    // Tables are never modified or removed once inserted and the map doesn't move its nodes,
+    // so the returned pointer stays valid after the lock is released.
+    {
+        const std::shared_lock lock(_column_mutex);
+        if (const auto it = _column_tables.find(row); it != _column_tables.end()) return &it->second;
+    }
+
+    ColumnCheckpoint current = {};
+    ColumnTable table = { current };
+    size_t next_checkpoint = COLUMN_CHECKPOINT_INTERVAL;
+    for (auto& [byte_column, code_point_column, utf16_column, visual_column] = current.columns; byte_column < line.size();) {
+        if (byte_column >= next_checkpoint) {
+            table.push_back(current);
+            next_checkpoint = byte_column + COLUMN_CHECKPOINT_INTERVAL;
+        }
+
+        const auto [width, byte_count] = get_visual_char(line, byte_column);
+        for (auto index = byte_column; index < byte_column + byte_count;) {
+            const auto [code_point, code_point_bytes] = decode_utf8(line, index);
+            code_point_column += 1;
+            utf16_column += (code_point > 0xFFFF) ? 2 : 1;
+            index += code_point_bytes;
+        }
+
+        visual_column += width;
+        byte_column += byte_count;
+    }
+
+    const std::unique_lock lock(_column_mutex);
+    return &_column_tables.try_emplace(row, std::move(table)).first->second;
+}
+
+void LineIndex::_mark_non_ascii(const size_t start, const size_t end) const {
+    _non_ascii.resize(_line_starts.size());
+
+    // Jumps from one non-ASCII byte to the next, skipping the rest of every row that was marked.
+    for (auto position = start; position < end;) {
+        position += ascii_prefix_length(_contents.substr(position, end - position));
+        if (position >= end) break;
+
+        const auto row = _line_starts.find(position);
+        _non_ascii[row] = true;
+
+        position = (row + 1 < _line_starts.size()) ? _line_starts[row + 1] : end;
+    }
+}
+
+void LineIndex::_scan_to_offset(const size_t offset) const {
+    if (_complete.load(std::memory_order_acquire)) return;
+
+    {
+        const std::shared_lock lock(_mutex);
+        if (_scanned >= offset) return;
+    }
+
+    const std::unique_lock lock(_mutex);
+    if (_scanned >= offset) return;
+
+    _scan(std::min(_contents.size(), std::max(offset, _scanned + LAZY_SCAN_CHUNK)));
+}
+
+void LineIndex::_scan_to_row(const size_t row) const {
+    if (_complete.load(std::memory_order_acquire)) return;
+
+    // The end of a row is only known once the start of the following row was found.
+    {
+        const std::shared_lock lock(_mutex);
+        if (_line_starts.size() > row + 1) return;
+    }
+
+    const std::unique_lock lock(_mutex);
+    while (_line_starts.size() <= row + 1 && !_complete.load(std::memory_order_relaxed)) {
+        _scan(std::min(_contents.size(), _scanned + LAZY_SCAN_CHUNK));
+    }
+}
+
+void LineIndex::_scan(const size_t end) const {
+    const auto input = _contents.substr(_scanned, end - _scanned);
+
+    // The kernels write 64-bit offsets, other encodings get them through a temporary buffer.
+    std::vector<size_t> buffer;
+    auto* output = _line_starts.wide_storage();
+    if (output == nullptr) output = &buffer;
+
+    if (_threads > 1 && input.size() >= _parallel_threshold) {
+        // Every worker gets at least one byte to scan, so tiny inputs with a low threshold still work.
+        find_line_starts_parallel(input, _scanned, *output, std::min(_threads, input.size()));
+    } else {
+        find_line_starts(input, _scanned, *output);
+    }
+
+    if (output == &buffer) _line_starts.append(buffer);
+
+    _mark_non_ascii(_scanned, end);
+
+    _scanned = end;
+    if (_scanned == _contents.size()) {
+        _line_starts.shrink_to_fit();
+        _non_ascii.shrink_to_fit();
+        _complete.store(true, std::memory_order_release);
+    }
+}
+
+bool LineIndex::_fits(const IndexData& data) const {
+    const auto& line_starts = data.line_starts;
+    if (line_starts.empty() || line_starts.front() != 0 || data.non_ascii.size() != line_starts.size()) return false;
+
+    // Every row but the first has to start right after a line feed, which catches most stale or corrupted data
+    // without scanning the contents. Line feeds that the data doesn't know about would go unnoticed.
+    for (size_t row = 1; row < line_starts.size(); ++row) {
+        const auto line_start = line_starts[row];
+        if (line_start <= line_starts[row - 1] || line_start > _contents.size()) return false;
+        if (_contents[line_start - 1] != '\n') return false;
+    }
+
+    return true;
+}
+
+std::shared_lock<std::shared_mutex> LineIndex::_read_lock() const {
+    // Once the scan completed the line starts never change again, so no lock is needed anymore.
+    if (_complete.load(std::memory_order_acquire)) return {};
+    return std::shared_lock(_mutex);
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,271 @@
+#include "pretty_diagnostics/mapped_source.hpp"
+#include "pretty_diagnostics/index_cache.hpp"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace pretty_diagnostics;
+
+#ifndef _WIN32
+static int to_advice(const AccessHint hint) {
+    switch (hint) {
+        case AccessHint::Sequential: return MADV_SEQUENTIAL;
+        case AccessHint::Random: return MADV_RANDOM;
+        case AccessHint::WillNeed: return MADV_WILLNEED;
+        case AccessHint::DontNeed: return MADV_DONTNEED;
+        case AccessHint::Normal:
+        default: return MADV_NORMAL;
+    }
+}
+#endif
+
+MappedFileSource::Mapping::Mapping(const std::filesystem::path& path) {
+#ifdef _WIN32
+    const auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("MappedFileSource::Mapping::Mapping(): could not open file: " + path.string());
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw std::runtime_error("MappedFileSource::Mapping::Mapping(): failed to determine file size: " + path.string());
+    }
+
+    size = static_cast<size_t>(file_size.QuadPart);
+    stamp = stamp_file(path).value_or(FileStamp{ .size = size });
+    if (size == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        throw std::runtime_error("MappedFileSource::Mapping::Mapping(): failed to map file: " + path.string());
+    }
+
+    data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (data == nullptr) {
+        throw std::runtime_error("MappedFileSource::Mapping::Mapping(): failed to map file: " + path.string());
+    }
+#else
+    const int file_descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor == -1) {
+        throw std::runtime_error("MappedFileSource::Mapping::Mapping(): could not open file: " + path.string());
+    }
+
+    struct stat file_stat{};
+    if (::fstat(file_descriptor, &file_stat) == -1) {
+        ::close(file_descriptor);
+        throw std::runtime_error("MappedFileSource::Mapping::Mapping(): failed to determine file size: " + path.string());
+    }
+
+    size = static_cast<size_t>(file_stat.st_size);
+    stamp = stamp_file(file_stat);
+    if (size == 0) {
+        ::close(file_descriptor);
+        return;
+    }
+
+    // The mapping keeps its own reference to the file, so the descriptor can be closed right away.
+    void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    ::close(file_descriptor);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("MappedFileSource::Mapping::Mapping(): failed to map file: " + path.string());
+    }
+
+    data = static_cast<const char*>(address);
+#endif
+}
+
+MappedFileSource::Mapping::~Mapping() {
+    if (data == nullptr) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    ::munmap(const_cast<char*>(data), size);
+#endif
+}
+
+MappedFileSource::MappedFileSource(const std::filesystem::path& path, const std::filesystem::path& working_path, const AccessHint hint,
+                                   const IndexConfig& config) :
+    _display_path(std::filesystem::relative(path, working_path).string()), _mapping(path),
+    _index(load_line_index(contents_view(), path, _mapping.stamp, config)) {
+    store_line_index(path, _index, _mapping.stamp, config);
+    advise(hint);
+}
+
+void MappedFileSource::advise(const AccessHint hint) const {
+#ifndef _WIN32
+    if (_mapping.data == nullptr) return;
+
+    ::madvise(const_cast<char*>(_mapping.data), _mapping.size, to_advice(hint));
+#else
+    (void) hint;
+#endif
+}
+
+void MappedFileSource::advise(const AccessHint hint, const Location& start, const Location& end) const {
+    if (end.index() < start.index() || end.index() > _mapping.size) {
+        throw std::runtime_error("MappedFileSource::advise(): invalid range");
+    }
+
+#ifndef _WIN32
+    if (_mapping.data == nullptr || start.index() == end.index()) return;
+
+    // madvise() requires a page aligned address, so the range is widened to the surrounding pages.
+    const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const auto aligned_start = start.index() - (start.index() % page_size);
+
+    ::madvise(const_cast<char*>(_mapping.data) + aligned_start, end.index() - aligned_start, to_advice(hint));
+#else
+    (void) hint;
+#endif
+}
+
+Location MappedFileSource::from_coords(const size_t row, const size_t column) const {
+    if (!_index.contains_row(row)) {
+        throw std::runtime_error("MappedFileSource::from_coords(): invalid coordinates, there are not enough rows present");
+    }
+
+    const auto line_start = _index.line_start(row);
+    const auto byte_column = _index.from_visual_column(row, column);
+
+    return { row, column, line_start + byte_column };
+}
+
+Location MappedFileSource::from_index(const size_t index) const {
+    if (index > _mapping.size) {
+        throw std::runtime_error("MappedFileSource::from_index(): invalid index, out of bounds");
+    }
+
+    const auto row = _index.row(index);
+    const auto byte_column = index - _index.line_start(row);
+    const auto visual_column = _index.to_visual_column(row, byte_column);
+
+    return { row, visual_column, index };
+}
+
+std::string MappedFileSource::substr(const Location& start, const Location& end) const {
+    return std::string(MappedFileSource::substr_view(start, end));
+}
+
+std::string_view MappedFileSource::substr_view(const Location& start, const Location& end) const {
+    const auto start_index = start.index();
+    const auto end_index = end.index();
+
+    if (end_index < start_index || end_index > _mapping.size || start_index > _mapping.size) {
+        throw std::runtime_error("MappedFileSource::substr_view(): invalid range");
+    }
+
+    return contents_view().substr(start_index, end_index - start_index);
+}
+
+std::string MappedFileSource::line(const Location& location) const {
+    return std::string(MappedFileSource::line_view(location.row()));
+}
+
+std::string MappedFileSource::line(const size_t line_number) const {
+    return std::string(MappedFileSource::line_view(line_number));
+}
+
+std::string_view MappedFileSource::line_view(const Location& location) const {
+    return MappedFileSource::line_view(location.row());
+}
+
+std::string_view MappedFileSource::line_view(const size_t line_number) const {
+    if (!_index.contains_row(line_number)) {
+        throw std::runtime_error("MappedFileSource::line_view(): invalid line number, there are not enough lines present");
+    }
+
+    return _index.line(line_number);
+}
+
+size_t MappedFileSource::line_count() const {
+    return _index.line_count();
+}
+
+bool MappedFileSource::has_line(const size_t line_number) const {
+    return _index.contains_row(line_number);
+}
+
+size_t MappedFileSource::line_start(const size_t line_number) const {
+    if (!_index.contains_row(line_number)) {
+        throw std::runtime_error("MappedFileSource::line_start(): invalid line number, there are not enough lines present");
+    }
+
+    return _index.line_start(line_number);
+}
+
+size_t MappedFileSource::convert_column(const size_t line_number, const size_t column, const ColumnUnit from, const ColumnUnit to) const {
+    if (!_index.contains_row(line_number)) {
+        throw std::runtime_error("MappedFileSource::convert_column(): invalid line number, there are not enough lines present");
+    }
+
+    return _index.convert_column(line_number, column, from, to);
+}
+
+const std::string& MappedFileSource::contents() const {
+    std::call_once(_contents_flag, [this] { _contents = std::string(contents_view()); });
+    return _contents;
+}
+
+std::string_view MappedFileSource::contents_view() const {
+    return { _mapping.data, _mapping.size };
+}
+
+std::string MappedFileSource::path() const {
+    return _display_path;
+}
+
+size_t MappedFileSource::size() const {
+    return _mapping.size;
+}
+
+std::ostream& operator<<(std::ostream& os, const MappedFileSource& source) {
+    os << "MappedFileSource(";
+    os << "path=\"" << source.path() << "\", ";
+    os << "size=\"" << source.size() << "\"";
+    os << ")";
+    return os;
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
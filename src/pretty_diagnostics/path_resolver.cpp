@@ -0,0 +1,60 @@
+#include "pretty_diagnostics/path_resolver.hpp"
+
+#include <mutex>
+
+using namespace pretty_diagnostics;
+
+PathResolver::PathResolver(const std::filesystem::path& working_path) :
+    _working_path(std::filesystem::weakly_canonical(working_path)), _current_path(std::filesystem::current_path()) {
+}
+
+std::string PathResolver::display_path(const std::filesystem::path& path) const {
+    auto key = path.string();
+
+    {
+        const std::shared_lock lock(_mutex);
+        if (const auto it = _display_paths.find(key); it != _display_paths.end()) return it->second;
+    }
+
+    const auto absolute_path = (path.is_absolute() ? path : _current_path / path).lexically_normal();
+    const auto relative_path = absolute_path.lexically_relative(_working_path);
+    // There is no relative path between different root names, so the absolute one is shown instead.
+    auto display_path = relative_path.empty() ? absolute_path.string() : relative_path.string();
+
+    const std::unique_lock lock(_mutex);
+    return _display_paths.try_emplace(std::move(key), std::move(display_path)).first->second;
+}
+
+size_t PathResolver::size() const {
+    const std::shared_lock lock(_mutex);
+    return _display_paths.size();
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,226 @@
+#include "pretty_diagnostics/region_source.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace pretty_diagnostics;
+
+static const Source& checked_parent(const std::shared_ptr<Source>& parent, const size_t start_index, const size_t end_index) {
+    if (!parent) {
+        throw std::runtime_error("RegionSource::RegionSource(): the parent source must not be null");
+    }
+
+    if (end_index < start_index || end_index > parent->size()) {
+        throw std::runtime_error("RegionSource::RegionSource(): invalid range");
+    }
+
+    return *parent;
+}
+
+RegionSource::RegionSource(std::shared_ptr<Source> parent, const size_t start_index, const size_t end_index, std::string display_path) :
+    _parent(std::move(parent)), _start(checked_parent(_parent, start_index, end_index).from_index(start_index)),
+    _end(_parent->from_index(end_index)), _display_path(std::move(display_path)) {
+    if (_display_path.empty()) _display_path = _parent->path();
+}
+
+Location RegionSource::to_parent(const Location& location) const {
+    if (location.index() > size()) {
+        throw std::runtime_error("RegionSource::to_parent(): invalid location, out of bounds");
+    }
+
+    return _parent->from_index(_start.index() + location.index());
+}
+
+Location RegionSource::from_parent(const Location& location) const {
+    if (!contains(location)) {
+        throw std::runtime_error("RegionSource::from_parent(): invalid location, outside of the region");
+    }
+
+    const auto row = location.row() - _start.row();
+    const auto column = row == 0 ? location.column() - _start.column() : location.column();
+
+    return { row, column, location.index() - _start.index() };
+}
+
+bool RegionSource::contains(const Location& location) const {
+    return location.index() >= _start.index() && location.index() <= _end.index();
+}
+
+Location RegionSource::from_coords(const size_t row, const size_t column) const {
+    if (row >= line_count()) {
+        throw std::runtime_error("RegionSource::from_coords(): invalid coordinates, there are not enough rows present");
+    }
+
+    const auto location = _parent->from_coords(_start.row() + row, row == 0 ? _start.column() + column : column);
+    // The last row can end in front of the end of its line in the parent.
+    const auto pin = _parent->pin();
+    const auto line_end = line_start(row) + line_view(row).size();
+    const auto index = std::min(location.index() - _start.index(), line_end);
+
+    return { row, column, index };
+}
+
+Location RegionSource::from_index(const size_t index) const {
+    if (index > size()) {
+        throw std::runtime_error("RegionSource::from_index(): invalid index, out of bounds");
+    }
+
+    return from_parent(_parent->from_index(_start.index() + index));
+}
+
+std::string RegionSource::substr(const Location& start, const Location& end) const {
+    return std::string(substr_view(start, end));
+}
+
+std::string_view RegionSource::substr_view(const Location& start, const Location& end) const {
+    const auto start_index = start.index();
+    const auto end_index = end.index();
+
+    if (end_index < start_index || end_index > size()) {
+        throw std::runtime_error("RegionSource::substr_view(): invalid range");
+    }
+
+    return contents_view().substr(start_index, end_index - start_index);
+}
+
+std::string RegionSource::line(const Location& location) const {
+    return std::string(line_view(location.row()));
+}
+
+std::string RegionSource::line(const size_t line_number) const {
+    return std::string(line_view(line_number));
+}
+
+std::string_view RegionSource::line_view(const Location& location) const {
+    return line_view(location.row());
+}
+
+std::string_view RegionSource::line_view(const size_t line_number) const {
+    if (line_number >= line_count()) {
+        throw std::runtime_error("RegionSource::line_view(): invalid line number, there are not enough lines present");
+    }
+
+    // The view of the parent is taken last, as some parents only keep it valid until their next call.
+    const auto parent_row = _start.row() + line_number;
+    const auto parent_start = _parent->line_start(parent_row);
+    const auto parent_line = _parent->line_view(parent_row);
+
+    const auto begin = std::max(parent_start, _start.index());
+    const auto end = std::min(parent_start + parent_line.size(), _end.index());
+
+    return parent_line.substr(begin - parent_start, end - begin);
+}
+
+size_t RegionSource::line_count() const {
+    return _end.row() - _start.row() + 1;
+}
+
+size_t RegionSource::line_start(const size_t line_number) const {
+    if (line_number >= line_count()) {
+        throw std::runtime_error("RegionSource::line_start(): invalid line number, there are not enough lines present");
+    }
+
+    return line_number == 0 ? 0 : _parent->line_start(_start.row() + line_number) - _start.index();
+}
+
+size_t RegionSource::convert_column(const size_t line_number, const size_t column, const ColumnUnit from, const ColumnUnit to) const {
+    if (line_number >= line_count()) {
+        throw std::runtime_error("RegionSource::convert_column(): invalid line number, there are not enough lines present");
+    }
+
+    // The columns of a row are the columns of the parent's row, minus the ones in front of the region.
+    const auto parent_row = _start.row() + line_number;
+    const auto offset = _line_offset(line_number);
+    const auto pin = _parent->pin();
+    const auto line_size = line_view(line_number).size();
+
+    const auto from_offset = _parent->convert_column(parent_row, offset, ColumnUnit::Byte, from);
+    const auto byte_column = std::min(_parent->convert_column(parent_row, from_offset + column, from, ColumnUnit::Byte) - offset, line_size);
+
+    const auto to_offset = _parent->convert_column(parent_row, offset, ColumnUnit::Byte, to);
+    return _parent->convert_column(parent_row, offset + byte_column, ColumnUnit::Byte, to) - to_offset;
+}
+
+const std::string& RegionSource::contents() const {
+    std::call_once(_contents_flag, [this] {
+        const auto pin = _parent->pin();
+        _contents = std::string(contents_view());
+    });
+    return _contents;
+}
+
+std::string_view RegionSource::contents_view() const {
+    return _parent->substr_view(_start, _end);
+}
+
+std::shared_ptr<const void> RegionSource::pin() const {
+    return _parent->pin();
+}
+
+std::string RegionSource::path() const {
+    return _display_path;
+}
+
+size_t RegionSource::size() const {
+    return _end.index() - _start.index();
+}
+
+size_t RegionSource::_line_offset(const size_t line_number) const {
+    return line_number == 0 ? _start.index() - _parent->line_start(_start.row()) : 0;
+}
+
+Span pretty_diagnostics::to_parent(const Span& span) {
+    const auto region = std::dynamic_pointer_cast<RegionSource>(span.source());
+    if (!region) {
+        throw std::runtime_error("to_parent(): the source of the span is not a region");
+    }
+
+    return { region->parent(), region->to_parent(span.start()), region->to_parent(span.end()) };
+}
+
+Span pretty_diagnostics::to_region(const std::shared_ptr<RegionSource>& region, const Span& span) {
+    if (span.source() != region->parent()) {
+        throw std::runtime_error("to_region(): the span does not belong to the parent of the region");
+    }
+
+    return { region, region->from_parent(span.start()), region->from_parent(span.end()) };
+}
+
+std::ostream& operator<<(std::ostream& os, const RegionSource& source) {
+    os << "RegionSource(";
+    os << "path=\"" << source.path() << "\", ";
+    os << "start=\"" << source.start().index() << "\", ";
+    os << "size=\"" << source.size() << "\"";
+    os << ")";
+    return os;
+}
+
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -1,6 +1,8 @@
 #include "pretty_diagnostics/renderer.hpp"
+#include "pretty_diagnostics/expansion_source.hpp"
 #include "pretty_diagnostics/utils.hpp"
 
+#include <algorithm>
 #include <ranges>
 #include <unordered_map>
 #include <vector>
@@ -11,6 +13,7 @@ using namespace pretty_diagnostics;
 constexpr size_t MAX_TERMINAL_WIDTH = 80;
 constexpr long MIN_TEXT_WRAP = 10;
 constexpr long LINE_PADDING = 1;
+constexpr auto EXPANDED_FROM_TEXT = "expanded from here";
 
 GlyphSet Glyphs::Unicode() {
     return {
@@ -44,10 +47,9 @@ GlyphSet Glyphs::Ascii() {
     };
 }
 
-TextRenderer::TextRenderer(const Report& report, Config config) : _config(std::move(config)) {
-    _line_number_width = widest_line_number(report.file_groups(), LINE_PADDING) + 2;
-    _snippet_width = static_cast<int>(_line_number_width - 1);
-    _whitespaces = std::string(_line_number_width, ' ');
+TextRenderer::TextRenderer(const Report& report, Config config) :
+    _min_line_number_width(widest_line_number(report.file_groups(), LINE_PADDING)), _config(std::move(config)) {
+    _fit_line_numbers({});
 }
 
 void TextRenderer::render(const Severity& severity, std::ostream& stream) {
@@ -94,6 +96,10 @@ void TextRenderer::render(const Severity& severity, std::ostream& stream) {
 void TextRenderer::render(const Report& report, std::ostream& stream) {
     const auto& file_groups = report.file_groups();
 
+    // The expansion chains are only walked once per report, their line numbers may widen the gutter.
+    const auto expansions = _config.show_expansions ? expansion_groups(report) : std::vector<FileGroup>{};
+    _fit_line_numbers(expansions);
+
     this->render(report.severity(), stream);
 
     if (report.code().has_value()) {
@@ -125,6 +131,13 @@ void TextRenderer::render(const Report& report, std::ostream& stream) {
         render(file_group, stream);
     }
 
+    for (const auto& file_group : expansions) {
+        stream << _whitespaces << _config.glyphs.tee_right;
+        stream << _config.glyphs.cap_left << file_group.source()->path() << _config.glyphs.cap_right << "\n";
+
+        render(file_group, stream);
+    }
+
     if (report.note().has_value()) {
         const auto note_prefix = _whitespaces + _config.glyphs.line_vertical + " Note: ";
         const auto note_wrapped_prefix = _whitespaces + _config.glyphs.line_vertical + "       ";
@@ -151,9 +164,13 @@ void TextRenderer::render(const Report& report, std::ostream& stream) {
 }
 
 void TextRenderer::render(const FileGroup& file_group, std::ostream& stream) {
-    const auto max_line = static_cast<long>(file_group.source()->line_count());
+    const auto& source = file_group.source();
     const auto& line_groups = file_group.line_groups();
 
+    // Only the lines up to the padding after the last label are needed, so the source doesn't have to count all of its lines.
+    const auto last_padded_line = line_groups.empty() ? 0 : line_groups.rbegin()->first + LINE_PADDING;
+    const auto max_line = static_cast<long>(source->has_line(last_padded_line) ? last_padded_line + 1 : source->line_count());
+
     long max_rendered_line = -1;
     for (auto it = line_groups.begin(); it != line_groups.end(); ++it) {
         const auto& label_group = it->second;
@@ -175,7 +192,8 @@ void TextRenderer::render(const FileGroup& file_group, std::ostream& stream) {
             const bool render_label_here = line == current_line;
 
             if (source_line_needed) {
-                const auto line_text = file_group.source()->line(line);
+                const auto pin = source->pin();
+                const auto line_text = source->line_view(line);
                 stream << std::setw(static_cast<int>(_snippet_width))
                        << line + 1 << " "
                        << _config.glyphs.line_vertical << " "
@@ -294,11 +312,66 @@ size_t TextRenderer::widest_line_number(const Report::MappedFileGroups& groups,
     return visual_width(std::to_string(display_line));
 }
 
-std::vector<std::string> TextRenderer::wrap_text(const std::string& text, const size_t max_width) {
+std::vector<FileGroup> TextRenderer::expansion_groups(const Report& report) {
+    std::vector<std::vector<Span>> chains;
+    for (const auto& file_group : report.file_groups() | std::views::values) {
+        if (!dynamic_cast<const ExpansionSource*>(file_group.source().get())) continue;
+
+        for (const auto& line_group : file_group.line_groups() | std::views::values) {
+            for (const auto& label : line_group.labels()) {
+                if (auto chain = expansion_chain(label.span()); !chain.empty()) chains.push_back(std::move(chain));
+            }
+        }
+    }
+
+    std::vector<FileGroup> groups;
+    std::unordered_map<const Source*, size_t> group_indices;
+
+    const auto add_span = [&](const Span& span) {
+        const auto& source = span.source();
+        const auto row = span.start().row();
+
+        // Labels are drawn on a single row, so a span that continues on the next rows is cut at the end of its first one.
+        auto end = span.end();
+        if (end.row() != row) {
+            const auto pin = source->pin();
+            end = source->from_index(source->line_start(row) + source->line_view(row).size());
+        }
+        if (end.index() <= span.start().index()) return;
+
+        const auto [index_it, inserted] = group_indices.try_emplace(source.get(), groups.size());
+        if (inserted) groups.emplace_back(source);
+
+        auto& line_groups = groups[index_it->second].line_groups();
+        auto& labels = line_groups.try_emplace(row, row).first->second.labels();
+
+        auto clipped = Span(source, span.start(), end);
+        if (std::ranges::any_of(labels, [&clipped](const Label& label) { return label.span().intersects(clipped); })) return;
+
+        labels.insert(Label(EXPANDED_FROM_TEXT, std::move(clipped)));
+    };
+
+    // The innermost layer of every chain comes first, so the groups read from the expansion outwards.
+    for (size_t depth = 0; std::ranges::any_of(chains, [depth](const auto& chain) { return depth < chain.size(); }); ++depth) {
+        for (const auto& chain : chains) {
+            if (depth < chain.size()) add_span(chain[depth]);
+        }
+    }
+
+    // A span that was dropped can leave an empty line group behind, which must not be rendered.
+    for (auto& group : groups) {
+        erase_if(group.line_groups(), [](const auto& entry) { return entry.second.labels().empty(); });
+    }
+    std::erase_if(groups, [](const FileGroup& group) { return group.line_groups().empty(); });
+
+    return groups;
+}
+
+std::vector<std::string> TextRenderer::wrap_text(const std::string_view text, const size_t max_width) {
     std::vector<std::string> lines;
     if (text.empty()) return lines;
 
-    std::istringstream line_stream(text);
+    std::istringstream line_stream{ std::string(text) };
     std::string current_paragraph;
 
     // Always read an entire paragraph at once to ensure \n still works.
@@ -384,7 +457,7 @@ std::vector<std::string> TextRenderer::wrap_text(const std::string& text, const
     return lines;
 }
 
-void TextRenderer::print_wrapped_text(const std::string& text, const std::string& wrapped_prefix, const size_t max_width, std::ostream& stream) {
+void TextRenderer::print_wrapped_text(const std::string_view text, const std::string& wrapped_prefix, const size_t max_width, std::ostream& stream) {
     const auto lines = wrap_text(text, max_width);
     if (lines.empty()) {
         stream << "\n";
@@ -398,6 +471,18 @@ void TextRenderer::print_wrapped_text(const std::string& text, const std::string
     }
 }
 
+void TextRenderer::_fit_line_numbers(const std::span<const FileGroup> expansions) {
+    auto line_number_width = _min_line_number_width;
+    for (const auto& group : expansions) {
+        const auto display_line = group.line_groups().rbegin()->first + 1 + LINE_PADDING;
+        line_number_width = std::max(line_number_width, visual_width(std::to_string(display_line)));
+    }
+
+    _line_number_width = line_number_width + 2;
+    _snippet_width = static_cast<int>(_line_number_width - 1);
+    _whitespaces = std::string(_line_number_width, ' ');
+}
+
 // BSD 3-Clause License
 //
 // Copyright (c) 2025, Timo Behrend
@@ -1,88 +1,270 @@
 #include "pretty_diagnostics/report.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <ranges>
 #include <stdexcept>
 
 using namespace pretty_diagnostics;
 
-LineGroup::LineGroup(const size_t line_number, std::set<Label> labels) :
-    _labels(std::move(labels)), _line_number(line_number) {
+// Copies an optional string into the memory of the given allocator
+static std::optional<std::pmr::string> to_pmr(const std::optional<std::string_view> text, const std::pmr::polymorphic_allocator<>& allocator) {
+    if (!text.has_value()) return std::nullopt;
+    return std::pmr::string(*text, allocator);
 }
 
-FileGroup::FileGroup(const std::shared_ptr<Source>& source, MappedLineGroups line_groups) :
-    _source(source), _line_groups(std::move(line_groups)) {
+static std::optional<std::pmr::string> to_pmr(std::optional<std::pmr::string>&& text, const std::pmr::polymorphic_allocator<>& allocator) {
+    if (!text.has_value()) return std::nullopt;
+    return std::pmr::string(std::move(*text), allocator);
 }
 
-Report::Report(std::string message, std::optional<std::string> code, const Severity severity,
-               MappedFileGroups file_groups, std::optional<std::string> note, std::optional<std::string> help) :
-    _code(std::move(code)), _note(std::move(note)), _help(std::move(help)),
-    _file_groups(std::move(file_groups)), _message(std::move(message)), _severity(severity) {
+// Removes the line groups without labels, which the builder keeps across resets, and the files left without any.
+static void prune_groups(Report::MappedFileGroups& file_groups) {
+    for (auto& file_group : file_groups | std::views::values) {
+        erase_if(file_group.line_groups(), [](const auto& entry) { return entry.second.labels().empty(); });
+    }
+
+    std::erase_if(file_groups, [](const auto& entry) { return entry.second.line_groups().empty(); });
+}
+
+// Labels of a line never intersect and are ordered by their start, which orders their ends as well.
+// The labels starting before the end of the span are a prefix, and the ones of them that end behind
+// its start are a suffix of that prefix, so the first intersecting label is found by two binary searches.
+static const Label* find_intersection(const LineGroup::Labels& labels, const Span& span) {
+    const auto candidates_end = std::ranges::upper_bound(labels, span.end().index(), {}, [](const Label& label) { return label.span().start().index(); });
+    const auto first = std::ranges::partition_point(labels.begin(), candidates_end, [&span](const Label& label) { return label.span().end().index() <= span.start().index(); });
+    return first != candidates_end ? &*first : nullptr;
+}
+
+[[noreturn]] static void throw_intersection(const std::string_view function, const Label& label) {
+    if (label.span().start().row() != label.span().end().row()) {
+        throw std::runtime_error(std::string(function) + ": currently multi-row spans are not supported");
+    }
+
+    throw std::runtime_error(std::string(function) + ": there is an intersection with a different label");
+}
+
+// Orders labels by their file group, line group and position within the line
+static bool by_position(const Label& lhs, const Label& rhs) {
+    const auto* lhs_source = lhs.span().source().get();
+    const auto* rhs_source = rhs.span().source().get();
+    if (lhs_source != rhs_source) return std::less()(lhs_source, rhs_source);
+
+    if (lhs.span().line() != rhs.span().line()) return lhs.span().line() < rhs.span().line();
+    return lhs < rhs;
+}
+
+static bool same_line(const Label& lhs, const Label& rhs) {
+    return lhs.span().source() == rhs.span().source() && lhs.span().line() == rhs.span().line();
+}
+
+LineGroup::LineGroup(const size_t line_number, const allocator_type& allocator) :
+    _labels(allocator), _line_number(line_number) {
+}
+
+LineGroup::LineGroup(const size_t line_number, Labels labels, const allocator_type& allocator) :
+    _labels(std::move(labels), allocator), _line_number(line_number) {
+}
+
+LineGroup::LineGroup(const LineGroup& other, const allocator_type& allocator) :
+    _labels(other._labels, allocator), _line_number(other._line_number) {
+}
+
+LineGroup::LineGroup(LineGroup&& other, const allocator_type& allocator) :
+    _labels(std::move(other._labels), allocator), _line_number(other._line_number) {
+}
+
+FileGroup::FileGroup(const std::shared_ptr<Source>& source, const allocator_type& allocator) :
+    _source(source), _line_groups(allocator) {
+}
+
+FileGroup::FileGroup(const std::shared_ptr<Source>& source, MappedLineGroups line_groups, const allocator_type& allocator) :
+    _source(source), _line_groups(std::move(line_groups), allocator) {
+}
+
+FileGroup::FileGroup(const FileGroup& other, const allocator_type& allocator) :
+    _source(other._source), _line_groups(other._line_groups, allocator) {
+}
+
+FileGroup::FileGroup(FileGroup&& other, const allocator_type& allocator) :
+    _source(std::move(other._source)), _line_groups(std::move(other._line_groups), allocator) {
+}
+
+Report::Report(const std::string_view message, const std::optional<std::string_view> code, const Severity severity, MappedFileGroups file_groups,
+               const std::optional<std::string_view> note, const std::optional<std::string_view> help, const allocator_type& allocator) :
+    _code(to_pmr(code, allocator)), _note(to_pmr(note, allocator)), _help(to_pmr(help, allocator)),
+    _file_groups(std::move(file_groups), allocator), _message(message, allocator), _severity(severity) {
+}
+
+Report::Report(const Report& other, const allocator_type& allocator) :
+    _code(to_pmr(other._code, allocator)), _note(to_pmr(other._note, allocator)), _help(to_pmr(other._help, allocator)),
+    _file_groups(other._file_groups, allocator), _message(other._message, allocator), _severity(other._severity) {
+}
+
+Report::Report(Report&& other, const allocator_type& allocator) :
+    _code(to_pmr(std::move(other._code), allocator)), _note(to_pmr(std::move(other._note), allocator)),
+    _help(to_pmr(std::move(other._help), allocator)), _file_groups(std::move(other._file_groups), allocator),
+    _message(std::move(other._message), allocator), _severity(other._severity) {
+}
+
+Report::Report(Builder&& builder) :
+    _code(std::move(builder._code)), _note(std::move(builder._note)), _help(std::move(builder._help)),
+    _file_groups(std::move(builder._file_groups)), _message(std::move(builder._message.value())),
+    _severity(builder._severity.value_or(Severity::Error)) {
 }
 
 void Report::render(IReporterRenderer& renderer, std::ostream& stream) const {
     renderer.render(*this, stream);
 }
 
+Report::Builder::Builder(const allocator_type& allocator) :
+    _file_groups(allocator) {
+}
+
 Report::Builder& Report::Builder::severity(Severity severity) {
     _severity = severity;
     return *this;
 }
 
-Report::Builder& Report::Builder::message(std::string message) {
-    _message = std::move(message);
+Report::Builder& Report::Builder::message(const std::string_view message) {
+    _message = to_pmr(message, get_allocator());
     return *this;
 }
 
-Report::Builder& Report::Builder::code(std::string code) {
-    _code = std::move(code);
+Report::Builder& Report::Builder::code(const std::string_view code) {
+    _code = to_pmr(code, get_allocator());
     return *this;
 }
 
-Report::Builder& Report::Builder::label(std::string text, Span span) {
+Report::Builder& Report::Builder::label(const std::string_view text, Span span) {
     if (text.empty()) throw std::runtime_error("Report::Builder::label(): label text is empty");
 
-    auto& file_group = _file_groups.try_emplace(span.source(), FileGroup(span.source(), FileGroup::MappedLineGroups())).first->second;
-    auto& line_group = file_group.line_groups().try_emplace(span.line(), LineGroup(span.line(), {})).first->second;
+    // The groups are constructed in place, so they pick up the allocator of their container.
+    auto& file_group = _file_groups.try_emplace(span.source(), span.source()).first->second;
+    auto& line_group = file_group.line_groups().try_emplace(span.line(), span.line()).first->second;
+
+    if (const auto* label = find_intersection(line_group.labels(), span)) {
+        throw_intersection("Report::Builder::label()", *label);
+    }
+
+    line_group.labels().emplace(text, std::move(span));
+
+    return *this;
+}
+
+Report::Builder& Report::Builder::_insert_labels(std::pmr::vector<Label> batch) {
+    constexpr auto FUNCTION = "Report::Builder::labels()";
+
+    if (std::ranges::any_of(batch, [](const Label& label) { return label.text().empty(); })) {
+        throw std::runtime_error(std::string(FUNCTION) + ": label text is empty");
+    }
+
+    std::ranges::stable_sort(batch, by_position);
+
+    // Everything is validated before the first label is added, so a rejected batch leaves the builder untouched.
+    const LineGroup::Labels* existing = nullptr;
+    const Label* previous = nullptr;
+    for (auto it = batch.begin(); it != batch.end(); ++it) {
+        if (it == batch.begin() || !same_line(*std::prev(it), *it)) {
+            existing = nullptr;
+            previous = nullptr;
 
-    for (const auto& label : line_group.labels()) {
-        if (!label.span().intersects(span)) continue;
+            if (const auto file_it = _file_groups.find(it->span().source()); file_it != _file_groups.end()) {
+                const auto& line_groups = file_it->second.line_groups();
+                if (const auto line_it = line_groups.find(it->span().line()); line_it != line_groups.end()) existing = &line_it->second.labels();
+            }
+        }
+
+        if (existing) {
+            if (const auto* label = find_intersection(*existing, it->span())) throw_intersection(FUNCTION, *label);
+
+            // A label that starts where an existing one does is dropped, just like when it is added alone.
+            if (existing->contains(*it)) continue;
+        }
 
-        if (label.span().start().row() != label.span().end().row()) {
-            throw std::runtime_error("Report::Builder::label(): currently multi-row spans are not supported");
+        if (previous) {
+            // The labels intersect if the previous one ends behind the start of this one. Otherwise a previous
+            // label that starts at the same position is empty, and this one is dropped just like after an existing one.
+            if (previous->span().end().index() > it->span().start().index()) throw_intersection(FUNCTION, *previous);
+            if (!(*previous < *it)) continue;
         }
 
-        throw std::runtime_error("Report::Builder::label(): there is an intersection with a different label");
+        previous = &*it;
     }
 
-    line_group.labels().insert(Label(std::move(text), std::move(span)));
+    for (auto first = batch.begin(); first != batch.end();) {
+        const auto last = std::find_if_not(first, batch.end(), [&first](const Label& label) { return same_line(*first, label); });
+
+        const auto& span = first->span();
+        auto& file_group = _file_groups.try_emplace(span.source(), span.source()).first->second;
+        auto& line_group = file_group.line_groups().try_emplace(span.line(), span.line()).first->second;
+        line_group.labels().insert(std::make_move_iterator(first), std::make_move_iterator(last));
+
+        first = last;
+    }
 
     return *this;
 }
 
-Report::Builder& Report::Builder::note(std::string note) {
-    _note = std::move(note);
+Report::Builder& Report::Builder::note(const std::string_view note) {
+    _note = to_pmr(note, get_allocator());
     return *this;
 }
 
-Report::Builder& Report::Builder::help(std::string help) {
-    _help = std::move(help);
+Report::Builder& Report::Builder::help(const std::string_view help) {
+    _help = to_pmr(help, get_allocator());
     return *this;
 }
 
-Report Report::Builder::build() const {
+Report Report::Builder::build() const & {
     if (!_message.has_value()) {
         throw std::runtime_error("Report::Builder::build(): message is not set");
     }
 
+    auto file_groups = MappedFileGroups(_file_groups, get_allocator());
+    prune_groups(file_groups);
+
     return {
         _message.value(),
         _code,
         _severity.value_or(Severity::Error),
-        _file_groups,
+        std::move(file_groups),
         _note,
         _help,
+        get_allocator(),
     };
 }
 
+Report Report::Builder::build() && {
+    if (!_message.has_value()) {
+        throw std::runtime_error("Report::Builder::build(): message is not set");
+    }
+
+    prune_groups(_file_groups);
+
+    auto report = Report(std::move(*this));
+    reset();
+
+    return report;
+}
+
+Report::Builder& Report::Builder::reset() {
+    _message.reset();
+    _code.reset();
+    _note.reset();
+    _help.reset();
+    _severity.reset();
+
+    // Lines that weren't labelled since the last reset are dropped, the others keep the storage of their labels
+    // for the next report.
+    prune_groups(_file_groups);
+    for (auto& file_group : _file_groups | std::views::values) {
+        for (auto& line_group : file_group.line_groups() | std::views::values) line_group.labels().clear();
+    }
+
+    return *this;
+}
+
 // BSD 3-Clause License
 //
 // Copyright (c) 2025, Timo Behrend
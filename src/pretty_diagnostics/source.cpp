@@ -1,33 +1,180 @@
 #include "pretty_diagnostics/source.hpp"
+#include "pretty_diagnostics/index_cache.hpp"
 #include "pretty_diagnostics/utils.hpp"
 
 #include <algorithm>
+#include <limits>
+
+#ifdef _WIN32
 #include <fstream>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace pretty_diagnostics;
 
+// Lines a cursor walks forward one by one, before it searches for the line of an index instead
+constexpr size_t MAX_CURSOR_ROW_STEPS = 8;
+
 Location::Location(const size_t row, const size_t column, const size_t index) :
     _row(row), _column(column), _index(index) {
 }
 
-StringSource::StringSource(std::string contents, std::string display_path) :
-    _display_path(std::move(display_path)), _contents(std::move(contents)) {
-    _line_starts.push_back(0);
-    for (size_t index = 0; index < _contents.size(); ++index) {
-        if (_contents[index] == '\n') {
-            _line_starts.push_back(index + 1);
+bool Source::has_line(const size_t line_number) const {
+    return line_number < line_count();
+}
+
+size_t Source::line_start(const size_t line_number) const {
+    return from_coords(line_number, 0).index();
+}
+
+size_t Source::convert_column(const size_t line_number, const size_t column, const ColumnUnit from, const ColumnUnit to) const {
+    const auto pin = this->pin();
+    return pretty_diagnostics::convert_column(line_view(line_number), column, from, to);
+}
+
+size_t Source::column(const Location& location, const ColumnUnit unit) const {
+    const auto byte_column = location.index() - line_start(location.row());
+    return convert_column(location.row(), byte_column, ColumnUnit::Byte, unit);
+}
+
+Location Source::from_unit_coords(const size_t row, const size_t column, const ColumnUnit unit) const {
+    const auto byte_column = convert_column(row, column, unit, ColumnUnit::Byte);
+    const auto visual_column = convert_column(row, byte_column, ColumnUnit::Byte, ColumnUnit::Visual);
+
+    return { row, visual_column, line_start(row) + byte_column };
+}
+
+std::shared_ptr<const void> Source::pin() const {
+    return nullptr;
+}
+
+std::vector<Location> Source::from_indices(const std::span<const size_t> indices) const {
+    if (!std::ranges::is_sorted(indices)) {
+        throw std::runtime_error("Source::from_indices(): the indices have to be sorted");
+    }
+
+    std::vector<Location> locations;
+    locations.reserve(indices.size());
+
+    auto cursor = LocationCursor(*this);
+    for (const auto index : indices) {
+        locations.push_back(cursor.locate(index));
+    }
+
+    return locations;
+}
+
+LocationCursor::LocationCursor(const Source& source) :
+    _source(&source), _size(source.size()), _row(0), _row_start(0), _next_row_start(0), _target_column(0), _byte_column(0),
+    _visual_column(0), _ascii(true) {
+    _enter_row(0);
+}
+
+Location LocationCursor::locate(const size_t index) {
+    if (index > _size) {
+        throw std::runtime_error("LocationCursor::locate(): invalid index, out of bounds");
+    }
+
+    if (index < _row_start) {
+        _enter_row(_source->from_index(index).row());
+    } else if (index >= _next_row_start) {
+        // Tokens are usually only a few lines apart, larger jumps are resolved with a binary search instead.
+        for (size_t step = 0; step < MAX_CURSOR_ROW_STEPS && index >= _next_row_start; ++step) {
+            _enter_row(_row + 1);
         }
+
+        if (index >= _next_row_start) _enter_row(_source->from_index(index).row());
     }
+
+    const auto target_column = index - _row_start;
+    if (_ascii) return { _row, std::min(target_column, _line.size()), index };
+
+    if (target_column < _target_column) {
+        _byte_column = 0;
+        _visual_column = 0;
+    }
+
+    // Continues decoding where the previous index of this row stopped, which is where a decode from the
+    // start of the row would be as well, as long as the target didn't move backwards.
+    while (_byte_column < target_column && _byte_column < _line.size()) {
+        const auto [width, byte_count] = get_visual_char(_line, _byte_column);
+        _visual_column += width;
+        _byte_column += byte_count;
+    }
+
+    _target_column = target_column;
+    return { _row, _visual_column, index };
+}
+
+void LocationCursor::_enter_row(const size_t row) {
+    _row = row;
+    _row_start = _source->line_start(row);
+    _next_row_start = _source->has_line(row + 1) ? _source->line_start(row + 1) : std::numeric_limits<size_t>::max();
+
+    // The line is copied, so the source is only pinned while entering the row and not for the lifetime of the cursor.
+    const auto pin = _source->pin();
+    _line.assign(_source->line_view(row));
+    _ascii = ascii_prefix_length(_line) == _line.size();
+
+    _target_column = 0;
+    _byte_column = 0;
+    _visual_column = 0;
+}
+
+StringSource::StringSource(std::string contents, std::string display_path, const IndexConfig& config) :
+    _display_path(std::move(display_path)), _contents(std::move(contents)), _index(_contents, config) {
+}
+
+StringSource::StringSource(std::string contents, std::string display_path, const std::filesystem::path& file, const FileStamp& stamp,
+                           const IndexConfig& config) :
+    _display_path(std::move(display_path)), _contents(std::move(contents)), _index(load_line_index(_contents, file, stamp, config)) {
+}
+
+// The index refers to the buffer of the source it was taken from, so it is pointed at the own buffer afterward.
+StringSource::StringSource(const StringSource& other) :
+    Source(other), _display_path(other._display_path), _contents(other._contents), _index(other._index) {
+    _index.rebind(_contents);
+}
+
+StringSource::StringSource(StringSource&& other) noexcept :
+    Source(std::move(other)), _display_path(std::move(other._display_path)), _contents(std::move(other._contents)),
+    _index(std::move(other._index)) {
+    _index.rebind(_contents);
+}
+
+StringSource& StringSource::operator=(const StringSource& other) {
+    if (this == &other) return *this;
+
+    _display_path = other._display_path;
+    _contents = other._contents;
+    _index = other._index;
+    _index.rebind(_contents);
+
+    return *this;
+}
+
+StringSource& StringSource::operator=(StringSource&& other) noexcept {
+    if (this == &other) return *this;
+
+    _display_path = std::move(other._display_path);
+    _contents = std::move(other._contents);
+    _index = std::move(other._index);
+    _index.rebind(_contents);
+
+    return *this;
 }
 
 Location StringSource::from_coords(size_t row, size_t column) const {
-    if (row >= _line_starts.size()) {
+    if (!_index.contains_row(row)) {
         throw std::runtime_error("StringSource::from_coords(): invalid coordinates, there are not enough rows present");
     }
 
-    const auto line_start = _line_starts[row];
-    const auto line_text = this->line(row);
-    const auto byte_column = from_visual_column(line_text, column);
+    const auto line_start = _index.line_start(row);
+    const auto byte_column = _index.from_visual_column(row, column);
 
     return { row, column, line_start + byte_column };
 }
@@ -37,55 +184,80 @@ Location StringSource::from_index(const size_t index) const {
         throw std::runtime_error("StringSource::from_index(): invalid index, out of bounds");
     }
 
-    const auto it = std::ranges::upper_bound(_line_starts, index);
-    const auto row = (it == _line_starts.begin()) ? 0 : static_cast<size_t>(std::distance(_line_starts.begin(), it) - 1);
-    const auto byte_column = index - _line_starts[row];
-
-    const auto line_text = this->line(row);
-    const auto visual_column = to_visual_column(line_text, byte_column);
+    const auto row = _index.row(index);
+    const auto byte_column = index - _index.line_start(row);
+    const auto visual_column = _index.to_visual_column(row, byte_column);
 
     return { row, visual_column, index };
 }
 
 std::string StringSource::substr(const Location& start, const Location& end) const {
+    return std::string(StringSource::substr_view(start, end));
+}
+
+std::string_view StringSource::substr_view(const Location& start, const Location& end) const {
     const auto start_index = start.index();
     const auto end_index = end.index();
 
     if (end_index < start_index || end_index > _contents.size() || start_index > _contents.size()) {
-        throw std::runtime_error("StringSource::substr(): invalid range");
+        throw std::runtime_error("StringSource::substr_view(): invalid range");
     }
 
-    return _contents.substr(start_index, end_index - start_index);
+    return contents_view().substr(start_index, end_index - start_index);
 }
 
 std::string StringSource::line(const Location& location) const {
-    return StringSource::line(location.row());
+    return std::string(StringSource::line_view(location.row()));
 }
 
 std::string StringSource::line(const size_t line_number) const {
-    if (line_number >= _line_starts.size()) {
-        throw std::runtime_error("StringSource::line(): invalid line number, there are not enough lines present");
-    }
+    return std::string(StringSource::line_view(line_number));
+}
 
-    const size_t row = line_number;
-    const auto line_start = _line_starts[row];
-    const auto line_end = (row + 1 < _line_starts.size()) ? _line_starts[row + 1] : _contents.size();
+std::string_view StringSource::line_view(const Location& location) const {
+    return StringSource::line_view(location.row());
+}
 
-    auto result = _contents.substr(line_start, line_end - line_start);
-    if (!result.empty() && result.back() == '\n') result.pop_back();
-    if (!result.empty() && result.back() == '\r') result.pop_back();
+std::string_view StringSource::line_view(const size_t line_number) const {
+    if (!_index.contains_row(line_number)) {
+        throw std::runtime_error("StringSource::line_view(): invalid line number, there are not enough lines present");
+    }
 
-    return result;
+    return _index.line(line_number);
 }
 
 size_t StringSource::line_count() const {
-    return _line_starts.size();
+    return _index.line_count();
+}
+
+bool StringSource::has_line(const size_t line_number) const {
+    return _index.contains_row(line_number);
+}
+
+size_t StringSource::line_start(const size_t line_number) const {
+    if (!_index.contains_row(line_number)) {
+        throw std::runtime_error("StringSource::line_start(): invalid line number, there are not enough lines present");
+    }
+
+    return _index.line_start(line_number);
+}
+
+size_t StringSource::convert_column(const size_t line_number, const size_t column, const ColumnUnit from, const ColumnUnit to) const {
+    if (!_index.contains_row(line_number)) {
+        throw std::runtime_error("StringSource::convert_column(): invalid line number, there are not enough lines present");
+    }
+
+    return _index.convert_column(line_number, column, from, to);
 }
 
 const std::string& StringSource::contents() const {
     return _contents;
 }
 
+std::string_view StringSource::contents_view() const {
+    return _contents;
+}
+
 std::string StringSource::path() const {
     return _display_path;
 }
@@ -94,22 +266,36 @@ size_t StringSource::size() const {
     return _contents.size();
 }
 
-FileSource::FileSource(const std::filesystem::path& path, const std::filesystem::path& working_path)
-    : StringSource(_read_contents(path), std::filesystem::relative(path, working_path).string()) {}
+FileSource::FileSource(const std::filesystem::path& path, const std::filesystem::path& working_path, const IndexConfig& config)
+    : FileSource(read_file(path), std::filesystem::relative(path, working_path).string(), path, config) {
+}
 
-std::string FileSource::_read_contents(const std::filesystem::path& path) {
-    if (!std::filesystem::exists(path)) {
-        throw std::runtime_error("FileSource::_read_contents(): file does not exist: " + path.string());
+FileSource::FileSource(const std::filesystem::path& path, const PathResolver& resolver, const IndexConfig& config)
+    : FileSource(read_file(path), resolver.display_path(path), path, config) {
+}
+
+// The cache entry is keyed by the stamp of the read, so a change to the file afterward can't be paired with these contents.
+FileSource::FileSource(FileContents contents, std::string display_path, const std::filesystem::path& path, const IndexConfig& config)
+    : StringSource(std::move(contents.text), std::move(display_path), path, contents.stamp, config) {
+    store_line_index(path, line_index(), contents.stamp, config);
+}
+
+FileContents pretty_diagnostics::read_file(const std::filesystem::path& path) {
+#ifdef _WIN32
+    // Stamped before the read, so an entry stored for a file that changes meanwhile never matches it again.
+    const auto stamp = stamp_file(path);
+    if (!stamp) {
+        throw std::runtime_error("read_file(): could not open file: " + path.string());
     }
 
     std::ifstream stream(path, std::ios::binary | std::ios::ate);
     if (!stream.is_open()) {
-        throw std::runtime_error("FileSource::_read_contents(): could not open file: " + path.string());
+        throw std::runtime_error("read_file(): could not open file: " + path.string());
     }
 
     const auto size = stream.tellg();
     if (size < 0) {
-        throw std::runtime_error("FileSource::_read_contents(): failed to determine file size: " + path.string());
+        throw std::runtime_error("read_file(): failed to determine file size: " + path.string());
     }
 
     stream.seekg(0);
@@ -118,10 +304,44 @@ std::string FileSource::_read_contents(const std::filesystem::path& path) {
     contents.resize(size);
 
     if (!stream.read(contents.data(), size)) {
-        throw std::runtime_error("FileSource::_read_contents(): failed to read file: " + path.string());
+        throw std::runtime_error("read_file(): failed to read file: " + path.string());
+    }
+
+    return { std::move(contents), *stamp };
+#else
+    // A missing file is reported by open() itself, so the file costs one open() and one fstat() besides its reads.
+    const int file_descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor == -1) {
+        throw std::runtime_error("read_file(): could not open file: " + path.string());
+    }
+
+    struct stat file_stat{};
+    if (::fstat(file_descriptor, &file_stat) == -1) {
+        ::close(file_descriptor);
+        throw std::runtime_error("read_file(): failed to determine file size: " + path.string());
+    }
+
+    std::string contents;
+    contents.resize(static_cast<size_t>(file_stat.st_size));
+
+    size_t offset = 0;
+    while (offset < contents.size()) {
+        const auto count = ::read(file_descriptor, contents.data() + offset, contents.size() - offset);
+        if (count == -1 && errno == EINTR) continue;
+        if (count == -1) {
+            ::close(file_descriptor);
+            throw std::runtime_error("read_file(): failed to read file: " + path.string());
+        }
+
+        // The file shrank since it was stat'ed, its current contents are used.
+        if (count == 0) break;
+        offset += static_cast<size_t>(count);
     }
 
-    return contents;
+    ::close(file_descriptor);
+    contents.resize(offset);
+    return { std::move(contents), stamp_file(file_stat) };
+#endif
 }
 
 std::ostream& operator<<(std::ostream& os, const Location& location) {
@@ -0,0 +1,96 @@
+#include "pretty_diagnostics/source_loader.hpp"
+
+using namespace pretty_diagnostics;
+
+SourceLoader::SourceLoader(const LoaderConfig& config) :
+    _config(config), _resolver(config.resolver ? config.resolver : std::make_shared<const PathResolver>(config.working_path)) {
+    const auto threads = config.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : config.threads;
+
+    for (size_t worker = 0; worker < threads; ++worker) {
+        _workers.emplace_back([this](const std::stop_token& stop_token) { _work(stop_token); });
+    }
+}
+
+SourceLoader::~SourceLoader() {
+    // Every worker only stops once the queue is empty, so all handed out futures get fulfilled.
+    for (auto& worker : _workers) worker.request_stop();
+    _workers.clear();
+}
+
+std::future<std::shared_ptr<FileSource>> SourceLoader::load(std::filesystem::path path) {
+    std::promise<std::shared_ptr<FileSource>> promise;
+    auto future = promise.get_future();
+
+    {
+        const std::lock_guard lock(_mutex);
+        _queue.push_back({ std::move(path), std::move(promise) });
+    }
+
+    _condition.notify_one();
+    return future;
+}
+
+std::vector<std::future<std::shared_ptr<FileSource>>> SourceLoader::load(const std::span<const std::filesystem::path> paths) {
+    std::vector<std::future<std::shared_ptr<FileSource>>> futures;
+    futures.reserve(paths.size());
+
+    {
+        const std::lock_guard lock(_mutex);
+        for (const auto& path : paths) {
+            std::promise<std::shared_ptr<FileSource>> promise;
+            futures.push_back(promise.get_future());
+            _queue.push_back({ path, std::move(promise) });
+        }
+    }
+
+    _condition.notify_all();
+    return futures;
+}
+
+void SourceLoader::_work(const std::stop_token& stop_token) {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock lock(_mutex);
+            if (!_condition.wait(lock, stop_token, [this] { return !_queue.empty(); })) return;
+
+            task = std::move(_queue.front());
+            _queue.pop_front();
+        }
+
+        try {
+            task.promise.set_value(std::make_shared<FileSource>(task.path, *_resolver, _config.index));
+        } catch (...) {
+            task.promise.set_exception(std::current_exception());
+        }
+    }
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
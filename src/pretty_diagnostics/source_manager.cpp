@@ -0,0 +1,331 @@
+#include "pretty_diagnostics/source_manager.hpp"
+#include "pretty_diagnostics/source_loader.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace pretty_diagnostics;
+
+struct SourceManager::Registry {
+    explicit Registry(ManagerConfig config) :
+        config(std::move(config)), resolver(std::make_shared<const PathResolver>(this->config.working_path)) {
+    }
+
+    [[nodiscard]] std::shared_ptr<const FileSource> load(const std::filesystem::path& path) const {
+        return std::make_shared<const FileSource>(path, *resolver, config.index);
+    }
+
+    // The workers are only started by the first batch and then kept, so later batches don't pay for starting them.
+    [[nodiscard]] SourceLoader& source_loader() {
+        std::call_once(loader_flag, [this] {
+            loader = std::make_unique<SourceLoader>(LoaderConfig{ .threads = config.threads, .working_path = config.working_path,
+                                                                  .index = config.index, .resolver = resolver });
+        });
+
+        return *loader;
+    }
+
+    // Has to be called with the mutex held.
+    std::shared_ptr<const FileSource> install(const ManagedSource& source, std::shared_ptr<const FileSource> loaded) {
+        {
+            const std::lock_guard lock(source._mutex);
+            // Another thread could have loaded the source in the meantime, its copy is kept.
+            if (source._loaded) return source._loaded;
+            source._loaded = loaded;
+        }
+
+        source._resident_bytes = loaded->size() + loaded->line_index().memory_usage();
+        source._last_access.store(++clock, std::memory_order_relaxed);
+        resident_bytes += source._resident_bytes;
+        resident.push_back(&source);
+
+        trim(&source);
+        return loaded;
+    }
+
+    // Has to be called with the mutex held. Evicts the least recently used sources that aren't pinned, other than
+    // the given one, until the budget fits again.
+    void trim(const ManagedSource* kept) {
+        while (config.byte_budget != 0 && resident_bytes > config.byte_budget) {
+            const auto is_kept = [kept](const ManagedSource* candidate) {
+                return candidate == kept || candidate->_pins.load(std::memory_order_relaxed) > 0;
+            };
+            const auto victim = std::ranges::min_element(resident, {}, [&](const ManagedSource* candidate) {
+                return is_kept(candidate) ? UINT64_MAX : candidate->_last_access.load(std::memory_order_relaxed);
+            });
+            if (is_kept(*victim)) break;
+
+            evict(victim);
+        }
+    }
+
+    // Has to be called with the mutex held.
+    void evict(const std::vector<const ManagedSource*>::iterator it) {
+        const auto* source = *it;
+        {
+            const std::lock_guard lock(source->_mutex);
+            source->_loaded.reset();
+        }
+
+        resident_bytes -= source->_resident_bytes;
+        resident.erase(it);
+    }
+
+    ManagerConfig config;
+    std::shared_ptr<const PathResolver> resolver;
+    std::unordered_map<std::string, std::weak_ptr<ManagedSource>> sources;
+    std::vector<const ManagedSource*> resident;
+    size_t resident_bytes = 0;
+    std::atomic<uint64_t> clock = 0;
+    mutable std::mutex mutex;
+
+    std::unique_ptr<SourceLoader> loader;
+    std::once_flag loader_flag;
+};
+
+SourceManager::SourceManager(const ManagerConfig& config) :
+    _registry(std::make_shared<Registry>(config)) {
+}
+
+std::shared_ptr<ManagedSource> SourceManager::open(const std::filesystem::path& path) {
+    const auto canonical_path = std::filesystem::weakly_canonical(path);
+    if (auto source = _find(canonical_path)) return source;
+
+    // The file is read without holding the lock, so other sources can be opened at the same time.
+    return _adopt(canonical_path, _registry->load(canonical_path));
+}
+
+std::vector<std::shared_ptr<ManagedSource>> SourceManager::open_all(const std::span<const std::filesystem::path> paths) {
+    std::vector<std::shared_ptr<ManagedSource>> sources(paths.size());
+
+    std::vector<size_t> missing;
+    std::vector<std::filesystem::path> missing_paths;
+    for (size_t index = 0; index < paths.size(); ++index) {
+        auto canonical_path = std::filesystem::weakly_canonical(paths[index]);
+
+        sources[index] = _find(canonical_path);
+        if (sources[index]) continue;
+
+        missing.push_back(index);
+        missing_paths.push_back(std::move(canonical_path));
+    }
+
+    if (missing.empty()) return sources;
+
+    auto futures = _registry->source_loader().load(missing_paths);
+
+    for (size_t index = 0; index < missing.size(); ++index) {
+        sources[missing[index]] = _adopt(missing_paths[index], futures[index].get());
+    }
+
+    return sources;
+}
+
+size_t SourceManager::resident_bytes() const {
+    const std::lock_guard lock(_registry->mutex);
+    return _registry->resident_bytes;
+}
+
+size_t SourceManager::source_count() const {
+    const std::lock_guard lock(_registry->mutex);
+    return static_cast<size_t>(std::ranges::count_if(_registry->sources, [](const auto& entry) { return !entry.second.expired(); }));
+}
+
+std::shared_ptr<ManagedSource> SourceManager::_find(const std::filesystem::path& canonical_path) const {
+    const std::lock_guard lock(_registry->mutex);
+    if (const auto it = _registry->sources.find(canonical_path.string()); it != _registry->sources.end()) {
+        return it->second.lock();
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<ManagedSource> SourceManager::_adopt(const std::filesystem::path& canonical_path, std::shared_ptr<const FileSource> loaded) {
+    const std::lock_guard lock(_registry->mutex);
+
+    // Another thread could have opened the same file in the meantime, its source is handed out instead.
+    auto& entry = _registry->sources[canonical_path.string()];
+    if (auto source = entry.lock()) return source;
+
+    const auto source = std::shared_ptr<ManagedSource>(new ManagedSource(_registry, canonical_path, *loaded));
+    entry = source;
+    _registry->install(*source, std::move(loaded));
+
+    return source;
+}
+
+ManagedSource::ManagedSource(std::shared_ptr<SourceManager::Registry> registry, std::filesystem::path path, const FileSource& loaded) :
+    _registry(std::move(registry)), _path(std::move(path)), _display_path(loaded.path()), _size(loaded.size()), _resident_bytes(0),
+    _last_access(0), _pins(0) {
+}
+
+ManagedSource::~ManagedSource() {
+    const std::lock_guard lock(_registry->mutex);
+
+    if (const auto it = std::ranges::find(_registry->resident, this); it != _registry->resident.end()) {
+        _registry->evict(it);
+    }
+
+    if (const auto it = _registry->sources.find(_path.string()); it != _registry->sources.end() && it->second.expired()) {
+        _registry->sources.erase(it);
+    }
+}
+
+bool ManagedSource::is_loaded() const {
+    const std::lock_guard lock(_mutex);
+    return _loaded != nullptr;
+}
+
+bool ManagedSource::is_pinned() const {
+    return _pins.load(std::memory_order_acquire) > 0;
+}
+
+Location ManagedSource::from_coords(const size_t row, const size_t column) const {
+    return _acquire()->from_coords(row, column);
+}
+
+Location ManagedSource::from_index(const size_t index) const {
+    return _acquire()->from_index(index);
+}
+
+std::string ManagedSource::substr(const Location& start, const Location& end) const {
+    return _acquire()->substr(start, end);
+}
+
+std::string_view ManagedSource::substr_view(const Location& start, const Location& end) const {
+    return _pinned("ManagedSource::substr_view()")->substr_view(start, end);
+}
+
+std::string ManagedSource::line(const Location& location) const {
+    return _acquire()->line(location);
+}
+
+std::string ManagedSource::line(const size_t line_number) const {
+    return _acquire()->line(line_number);
+}
+
+std::string_view ManagedSource::line_view(const Location& location) const {
+    return _pinned("ManagedSource::line_view()")->line_view(location);
+}
+
+std::string_view ManagedSource::line_view(const size_t line_number) const {
+    return _pinned("ManagedSource::line_view()")->line_view(line_number);
+}
+
+size_t ManagedSource::line_count() const {
+    return _acquire()->line_count();
+}
+
+bool ManagedSource::has_line(const size_t line_number) const {
+    return _acquire()->has_line(line_number);
+}
+
+size_t ManagedSource::line_start(const size_t line_number) const {
+    return _acquire()->line_start(line_number);
+}
+
+size_t ManagedSource::convert_column(const size_t line_number, const size_t column, const ColumnUnit from, const ColumnUnit to) const {
+    return _acquire()->convert_column(line_number, column, from, to);
+}
+
+const std::string& ManagedSource::contents() const {
+    return _pinned("ManagedSource::contents()")->contents();
+}
+
+std::string_view ManagedSource::contents_view() const {
+    return _pinned("ManagedSource::contents_view()")->contents_view();
+}
+
+std::shared_ptr<const void> ManagedSource::pin() const {
+    while (true) {
+        auto loaded = _acquire();
+
+        // Evictions happen under the lock of the registry, so the source is either still loaded here or was evicted
+        // in the meantime, in which case it is loaded again.
+        const std::lock_guard registry_lock(_registry->mutex);
+        const std::lock_guard lock(_mutex);
+        if (_loaded != loaded) continue;
+
+        _pins.fetch_add(1, std::memory_order_acq_rel);
+        return { loaded.get(), [source = shared_from_this()](const FileSource*) { source->_unpin(); } };
+    }
+}
+
+std::string ManagedSource::path() const {
+    return _display_path;
+}
+
+size_t ManagedSource::size() const {
+    return _size;
+}
+
+std::shared_ptr<const FileSource> ManagedSource::_acquire() const {
+    {
+        const std::lock_guard lock(_mutex);
+        if (_loaded) {
+            _last_access.store(++_registry->clock, std::memory_order_relaxed);
+            return _loaded;
+        }
+    }
+
+    auto loaded = _registry->load(_path);
+
+    const std::lock_guard lock(_registry->mutex);
+    return _registry->install(*this, std::move(loaded));
+}
+
+std::shared_ptr<const FileSource> ManagedSource::_pinned(const std::string_view function) const {
+    // A pinned source is never evicted, so it is still loaded.
+    if (!is_pinned()) {
+        throw std::runtime_error(std::string(function) + ": the source has to be pinned while its views are in use");
+    }
+
+    return _acquire();
+}
+
+void ManagedSource::_unpin() const {
+    const std::lock_guard lock(_registry->mutex);
+
+    // The pin may have kept the sources above their budget.
+    if (_pins.fetch_sub(1, std::memory_order_acq_rel) == 1) _registry->trim(nullptr);
+}
+
+std::ostream& operator<<(std::ostream& os, const ManagedSource& source) {
+    os << "ManagedSource(";
+    os << "path=\"" << source.path() << "\", ";
+    os << "size=\"" << source.size() << "\", ";
+    os << "loaded=\"" << (source.is_loaded() ? "true" : "false") << "\"";
+    os << ")";
+    return os;
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
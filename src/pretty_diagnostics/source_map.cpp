@@ -0,0 +1,492 @@
+#include "pretty_diagnostics/source_map.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+
+using namespace pretty_diagnostics;
+
+namespace {
+/**
+ * @brief Reads the subset of JSON that a source map consists of
+ */
+class JsonReader {
+public:
+    explicit JsonReader(const std::string_view text) :
+        _text(text) {
+    }
+
+    [[nodiscard]] char peek() {
+        _skip_whitespace();
+        return _position < _text.size() ? _text[_position] : '\0';
+    }
+
+    bool consume(const char expected) {
+        if (peek() != expected) return false;
+
+        ++_position;
+        return true;
+    }
+
+    void expect(const char expected) {
+        if (!consume(expected)) _fail(std::string("expected '") + expected + "'");
+    }
+
+    [[nodiscard]] bool at_end() {
+        return peek() == '\0' && _position == _text.size();
+    }
+
+    [[nodiscard]] std::string string() {
+        expect('"');
+
+        std::string result;
+        while (_position < _text.size() && _text[_position] != '"') {
+            const auto character = _text[_position++];
+            if (character != '\\') {
+                result += character;
+                continue;
+            }
+
+            if (_position == _text.size()) break;
+            switch (const auto escaped = _text[_position++]) {
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'n': result += '\n'; break;
+                case 'r': result += '\r'; break;
+                case 't': result += '\t'; break;
+                case 'u': _append_utf8(result, _code_point()); break;
+                default: result += escaped; break;
+            }
+        }
+
+        expect('"');
+        return result;
+    }
+
+    [[nodiscard]] std::optional<std::string> nullable_string() {
+        if (_literal("null")) return std::nullopt;
+        return string();
+    }
+
+    [[nodiscard]] std::vector<std::optional<std::string>> nullable_strings() {
+        std::vector<std::optional<std::string>> result;
+
+        expect('[');
+        if (consume(']')) return result;
+
+        do {
+            result.push_back(nullable_string());
+        } while (consume(','));
+
+        expect(']');
+        return result;
+    }
+
+    [[nodiscard]] long long integer() {
+        _skip_whitespace();
+
+        const auto start = _position;
+        if (_position < _text.size() && _text[_position] == '-') ++_position;
+        while (_position < _text.size() && std::isdigit(static_cast<unsigned char>(_text[_position]))) ++_position;
+        if (_position == start) _fail("expected a number");
+
+        return std::stoll(std::string(_text.substr(start, _position - start)));
+    }
+
+    void skip_value() {
+        switch (peek()) {
+            case '"': (void) string(); return;
+            case '{': _skip_container('{', '}'); return;
+            case '[': _skip_container('[', ']'); return;
+            default: break;
+        }
+
+        if (_literal("true") || _literal("false") || _literal("null")) return;
+
+        // Numbers may have fractions and exponents, which no field of a source map uses.
+        const auto start = _position;
+        while (_position < _text.size() && std::string_view("+-.eE0123456789").find(_text[_position]) != std::string_view::npos) ++_position;
+        if (_position == start) _fail("unexpected character");
+    }
+
+private:
+    void _skip_whitespace() {
+        while (_position < _text.size() && std::isspace(static_cast<unsigned char>(_text[_position]))) ++_position;
+    }
+
+    bool _literal(const std::string_view literal) {
+        _skip_whitespace();
+        if (!_text.substr(_position).starts_with(literal)) return false;
+
+        _position += literal.size();
+        return true;
+    }
+
+    void _skip_container(const char open, const char close) {
+        expect(open);
+        if (consume(close)) return;
+
+        do {
+            if (open == '{') {
+                (void) string();
+                expect(':');
+            }
+
+            skip_value();
+        } while (consume(','));
+
+        expect(close);
+    }
+
+    [[nodiscard]] char32_t _code_point() {
+        const auto high = _hex_quad();
+        if (high < 0xD800 || high > 0xDBFF) return high;
+
+        // A high surrogate is followed by the escaped low surrogate of the same code point.
+        if (!_text.substr(_position).starts_with("\\u")) _fail("unpaired surrogate");
+        _position += 2;
+
+        const auto low = _hex_quad();
+        if (low < 0xDC00 || low > 0xDFFF) _fail("unpaired surrogate");
+
+        return 0x10000 + ((high - 0xD800) << 10) + (low - 0xDC00);
+    }
+
+    [[nodiscard]] char32_t _hex_quad() {
+        if (_position + 4 > _text.size()) _fail("truncated escape sequence");
+
+        char32_t value = 0;
+        for (size_t index = 0; index < 4; ++index) {
+            const auto character = _text[_position++];
+            value <<= 4;
+
+            if (character >= '0' && character <= '9') value |= character - '0';
+            else if (character >= 'a' && character <= 'f') value |= character - 'a' + 10;
+            else if (character >= 'A' && character <= 'F') value |= character - 'A' + 10;
+            else _fail("invalid escape sequence");
+        }
+
+        return value;
+    }
+
+    static void _append_utf8(std::string& output, const char32_t code_point) {
+        if (code_point < 0x80) {
+            output += static_cast<char>(code_point);
+        } else if (code_point < 0x800) {
+            output += static_cast<char>(0xC0 | (code_point >> 6));
+            output += static_cast<char>(0x80 | (code_point & 0x3F));
+        } else if (code_point < 0x10000) {
+            output += static_cast<char>(0xE0 | (code_point >> 12));
+            output += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            output += static_cast<char>(0x80 | (code_point & 0x3F));
+        } else {
+            output += static_cast<char>(0xF0 | (code_point >> 18));
+            output += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+            output += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            output += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+    }
+
+    [[noreturn]] void _fail(const std::string& message) const {
+        throw std::runtime_error("SourceMap::parse(): invalid JSON at offset " + std::to_string(_position) + ", " + message);
+    }
+
+private:
+    std::string_view _text;
+    size_t _position = 0;
+};
+} // namespace
+
+static int base64_value(const char character) {
+    if (character >= 'A' && character <= 'Z') return character - 'A';
+    if (character >= 'a' && character <= 'z') return character - 'a' + 26;
+    if (character >= '0' && character <= '9') return character - '0' + 52;
+    if (character == '+') return 62;
+    if (character == '/') return 63;
+    return -1;
+}
+
+// Every base64 digit carries five bits of the value and a continuation bit, the lowest bit of the value is its sign.
+static int64_t decode_vlq(const std::string_view mappings, size_t& position) {
+    uint64_t value = 0;
+    for (size_t shift = 0; shift < 64; shift += 5) {
+        if (position == mappings.size()) break;
+
+        const auto digit = base64_value(mappings[position++]);
+        if (digit < 0) break;
+
+        value |= static_cast<uint64_t>(digit & 0x1F) << shift;
+        if ((digit & 0x20) == 0) {
+            const auto magnitude = static_cast<int64_t>(value >> 1);
+            return (value & 1) ? -magnitude : magnitude;
+        }
+    }
+
+    throw std::runtime_error("SourceMap::parse(): invalid VLQ value in mappings");
+}
+
+static uint32_t checked_field(const int64_t value) {
+    if (value < 0 || value >= std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("SourceMap::parse(): mapping field out of range");
+    }
+
+    return static_cast<uint32_t>(value);
+}
+
+SourceMap SourceMap::parse(const std::string_view json) {
+    SourceMap map;
+    std::optional<long long> version;
+    std::optional<std::string> source_root, mappings;
+
+    JsonReader reader(json);
+    reader.expect('{');
+
+    if (!reader.consume('}')) {
+        do {
+            const auto key = reader.string();
+            reader.expect(':');
+
+            if (key == "version") {
+                version = reader.integer();
+            } else if (key == "sources") {
+                for (auto& source : reader.nullable_strings()) map._sources.push_back(source.value_or(""));
+            } else if (key == "sourcesContent") {
+                map._sources_content = reader.nullable_strings();
+            } else if (key == "sourceRoot") {
+                source_root = reader.nullable_string();
+            } else if (key == "mappings") {
+                mappings = reader.string();
+            } else if (key == "file") {
+                map._file = reader.nullable_string();
+            } else if (key == "sections") {
+                throw std::runtime_error("SourceMap::parse(): index maps with sections are not supported");
+            } else {
+                reader.skip_value();
+            }
+        } while (reader.consume(','));
+
+        reader.expect('}');
+    }
+
+    if (!reader.at_end()) {
+        throw std::runtime_error("SourceMap::parse(): unexpected trailing characters");
+    }
+
+    if (version != 3) {
+        throw std::runtime_error("SourceMap::parse(): only version 3 source maps are supported");
+    }
+
+    if (!mappings.has_value()) {
+        throw std::runtime_error("SourceMap::parse(): mappings are missing");
+    }
+
+    if (source_root.has_value() && !source_root->empty()) {
+        if (!source_root->ends_with('/')) *source_root += '/';
+        for (auto& source : map._sources) source.insert(0, *source_root);
+    }
+
+    map._sources_content.resize(map._sources.size());
+    map._decode(*mappings);
+
+    return map;
+}
+
+const SourceMapSegment* SourceMap::find(const size_t row, const size_t column) const {
+    const auto it = std::ranges::upper_bound(_segments, std::pair(row, column), {}, [](const SourceMapSegment& segment) {
+        return std::pair<size_t, size_t>(segment.generated_row, segment.generated_column);
+    });
+    if (it == _segments.begin()) return nullptr;
+
+    const auto& segment = *std::prev(it);
+    if (segment.generated_row != row || segment.source == UNMAPPED) return nullptr;
+
+    return &segment;
+}
+
+void SourceMap::_decode(const std::string_view mappings) {
+    // Apart from the generated column, which starts over in every row, all fields are relative to the previous segment.
+    uint32_t row = 0;
+    int64_t column = 0, source = 0, original_row = 0, original_column = 0;
+
+    size_t position = 0;
+    while (position < mappings.size()) {
+        if (mappings[position] == ';') {
+            ++row;
+            column = 0;
+            ++position;
+            continue;
+        }
+
+        if (mappings[position] == ',') {
+            ++position;
+            continue;
+        }
+
+        int64_t fields[5];
+        size_t field_count = 0;
+        while (position < mappings.size() && mappings[position] != ',' && mappings[position] != ';') {
+            if (field_count == std::size(fields)) {
+                throw std::runtime_error("SourceMap::parse(): a segment has too many fields");
+            }
+
+            fields[field_count++] = decode_vlq(mappings, position);
+        }
+
+        if (field_count != 1 && field_count != 4 && field_count != 5) {
+            throw std::runtime_error("SourceMap::parse(): a segment has an invalid number of fields");
+        }
+
+        column += fields[0];
+        if (field_count == 1) {
+            _segments.push_back({ row, checked_field(column), UNMAPPED, 0, 0 });
+            continue;
+        }
+
+        source += fields[1];
+        original_row += fields[2];
+        original_column += fields[3];
+
+        if (source < 0 || static_cast<size_t>(source) >= _sources.size()) {
+            throw std::runtime_error("SourceMap::parse(): a segment refers to an unknown source");
+        }
+
+        _segments.push_back({ row, checked_field(column), static_cast<uint32_t>(source), checked_field(original_row), checked_field(original_column) });
+    }
+
+    // Segments of a row should already be sorted, but nothing forces a generator to do so.
+    std::ranges::stable_sort(_segments, {}, [](const SourceMapSegment& segment) {
+        return std::pair(segment.generated_row, segment.generated_column);
+    });
+}
+
+SourceMapSource::SourceMapSource(std::string contents, SourceMap map, std::vector<std::shared_ptr<Source>> originals, std::string display_path) :
+    StringSource(std::move(contents), std::move(display_path)), _map(std::move(map)), _originals(std::move(originals)) {
+    if (_originals.size() != _map.sources().size()) {
+        throw std::runtime_error("SourceMapSource::SourceMapSource(): every source of the map needs an original source");
+    }
+
+    if (std::ranges::any_of(_originals, [](const auto& original) { return !original; })) {
+        throw std::runtime_error("SourceMapSource::SourceMapSource(): the original sources must not be null");
+    }
+}
+
+std::shared_ptr<SourceMapSource> SourceMapSource::open(const std::filesystem::path& path, const std::filesystem::path& map_path,
+                                                       const std::filesystem::path& working_path) {
+    // Neither file is used as a plain source, so both are read without building a line index.
+    auto generated = read_file(path);
+
+    auto resolved_map_path = map_path;
+    if (resolved_map_path.empty()) resolved_map_path = path.string() + ".map";
+
+    auto map = SourceMap::parse(read_file(resolved_map_path).text);
+
+    std::vector<std::shared_ptr<Source>> originals;
+    for (size_t index = 0; index < map.sources().size(); ++index) {
+        const auto& source = map.sources()[index];
+        const auto original_path = resolved_map_path.parent_path() / source;
+
+        const auto& embedded = map.sources_content()[index];
+        if (embedded.has_value() && !std::filesystem::exists(original_path)) {
+            originals.push_back(std::make_shared<StringSource>(*embedded, source));
+        } else {
+            originals.push_back(std::make_shared<FileSource>(original_path, working_path));
+        }
+    }
+
+    return std::make_shared<SourceMapSource>(std::move(generated.text), std::move(map), std::move(originals),
+                                             std::filesystem::relative(path, working_path).string());
+}
+
+std::optional<OriginalLocation> SourceMapSource::original(const Location& location) const {
+    const auto column = _utf16_column(location);
+    return _translate(location.row(), column, column);
+}
+
+std::optional<Span> SourceMapSource::to_original(const Span& span) const {
+    if (span.source().get() != this) {
+        throw std::runtime_error("SourceMapSource::to_original(): the span belongs to another source");
+    }
+
+    const auto start = original(span.start());
+    if (!start) return std::nullopt;
+
+    // The end is looked up by the segment of the last character, it could start the segment of the next token otherwise.
+    std::optional<OriginalLocation> end;
+    if (span.end().index() > span.start().index()) {
+        const auto last = from_index(span.end().index() - 1);
+        const auto last_column = _utf16_column(last);
+
+        // A span that ends behind a newline ends one unit after its last character.
+        const auto end_column = span.end().row() == last.row() ? _utf16_column(span.end()) : last_column + 1;
+        end = _translate(last.row(), last_column, end_column);
+    }
+
+    const auto& source = start->source;
+    if (!end || end->source != source || end->location.index() <= start->location.index()) {
+        const auto row = start->location.row();
+        const auto pin = source->pin();
+        const auto line = source->line_view(row);
+        const auto byte_column = start->location.index() - source->line_start(row);
+        const auto char_size = byte_column < line.size() ? decode_utf8(line, byte_column).byte_count : 0;
+
+        return Span(source, start->location, source->from_index(start->location.index() + char_size));
+    }
+
+    return Span(source, start->location, end->location);
+}
+
+std::optional<OriginalLocation> SourceMapSource::_translate(const size_t row, const size_t lookup_column, const size_t column) const {
+    const auto* segment = _map.find(row, lookup_column);
+    if (!segment) return std::nullopt;
+
+    const auto& source = _originals[segment->source];
+    if (!source->has_line(segment->original_row)) return std::nullopt;
+
+    const auto original_column = segment->original_column + (column - segment->generated_column);
+    return OriginalLocation{ source, source->from_unit_coords(segment->original_row, original_column, ColumnUnit::Utf16) };
+}
+
+size_t SourceMapSource::_utf16_column(const Location& location) const {
+    const auto byte_column = location.index() - line_start(location.row());
+    return convert_column(location.row(), byte_column, ColumnUnit::Byte, ColumnUnit::Utf16);
+}
+
+std::ostream& operator<<(std::ostream& os, const SourceMapSource& source) {
+    os << "SourceMapSource(";
+    os << "path=\"" << source.path() << "\", ";
+    os << "size=\"" << source.size() << "\", ";
+    os << "segments=\"" << source.map().segments().size() << "\"";
+    os << ")";
+    return os;
+}
+
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -44,8 +44,10 @@ size_t Span::line() const {
 }
 
 std::ostream& operator<<(std::ostream& os, const Span& span) {
+    const auto pin = span.source()->pin();
+
     os << "Span(";
-    os << "contents=\"" << escape_string(span.substr()) << "\", ";
+    os << "contents=\"" << escape_string(span.source()->substr_view(span.start(), span.end())) << "\", ";
     os << "start=\"" << span.start() << "\", ";
     os << "end=\"" << span.end() << "\", ";
     os << "source=\"" << *span.source() << "\"";
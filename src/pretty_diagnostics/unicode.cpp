@@ -0,0 +1,321 @@
+#include "pretty_diagnostics/unicode.hpp"
+#include "pretty_diagnostics/utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+using namespace pretty_diagnostics;
+
+struct CodePointRange {
+    char32_t first, last;
+};
+
+// Code points that take no column of their own: combining marks (Mn, Me), format characters (Cf),
+// variation selectors and the medial and final Hangul Jamo, which join the syllable before them.
+constexpr CodePointRange ZERO_WIDTH_RANGES[] = {
+    { 0x0300, 0x036F }, { 0x0483, 0x0489 }, { 0x0591, 0x05BD }, { 0x05BF, 0x05BF }, { 0x05C1, 0x05C2 },
+    { 0x05C4, 0x05C5 }, { 0x05C7, 0x05C7 }, { 0x0610, 0x061A }, { 0x061C, 0x061C }, { 0x064B, 0x065F },
+    { 0x0670, 0x0670 }, { 0x06D6, 0x06DC }, { 0x06DF, 0x06E4 }, { 0x06E7, 0x06E8 }, { 0x06EA, 0x06ED },
+    { 0x0711, 0x0711 }, { 0x0730, 0x074A }, { 0x07A6, 0x07B0 }, { 0x07EB, 0x07F3 }, { 0x07FD, 0x07FD },
+    { 0x0816, 0x0819 }, { 0x081B, 0x0823 }, { 0x0825, 0x0827 }, { 0x0829, 0x082D }, { 0x0859, 0x085B },
+    { 0x0898, 0x089F }, { 0x08CA, 0x08E1 }, { 0x08E3, 0x0902 }, { 0x093A, 0x093A }, { 0x093C, 0x093C },
+    { 0x0941, 0x0948 }, { 0x094D, 0x094D }, { 0x0951, 0x0957 }, { 0x0962, 0x0963 }, { 0x0981, 0x0981 },
+    { 0x09BC, 0x09BC }, { 0x09C1, 0x09C4 }, { 0x09CD, 0x09CD }, { 0x09E2, 0x09E3 }, { 0x09FE, 0x09FE },
+    { 0x0A01, 0x0A02 }, { 0x0A3C, 0x0A3C }, { 0x0A41, 0x0A42 }, { 0x0A47, 0x0A48 }, { 0x0A4B, 0x0A4D },
+    { 0x0A51, 0x0A51 }, { 0x0A70, 0x0A71 }, { 0x0A75, 0x0A75 }, { 0x0A81, 0x0A82 }, { 0x0ABC, 0x0ABC },
+    { 0x0AC1, 0x0AC5 }, { 0x0AC7, 0x0AC8 }, { 0x0ACD, 0x0ACD }, { 0x0AE2, 0x0AE3 }, { 0x0AFA, 0x0AFF },
+    { 0x0B01, 0x0B01 }, { 0x0B3C, 0x0B3C }, { 0x0B3F, 0x0B3F }, { 0x0B41, 0x0B44 }, { 0x0B4D, 0x0B4D },
+    { 0x0B55, 0x0B56 }, { 0x0B62, 0x0B63 }, { 0x0B82, 0x0B82 }, { 0x0BC0, 0x0BC0 }, { 0x0BCD, 0x0BCD },
+    { 0x0C00, 0x0C00 }, { 0x0C04, 0x0C04 }, { 0x0C3C, 0x0C3C }, { 0x0C3E, 0x0C40 }, { 0x0C46, 0x0C48 },
+    { 0x0C4A, 0x0C4D }, { 0x0C55, 0x0C56 }, { 0x0C62, 0x0C63 }, { 0x0C81, 0x0C81 }, { 0x0CBC, 0x0CBC },
+    { 0x0CBF, 0x0CBF }, { 0x0CC6, 0x0CC6 }, { 0x0CCC, 0x0CCD }, { 0x0CE2, 0x0CE3 }, { 0x0D00, 0x0D01 },
+    { 0x0D3B, 0x0D3C }, { 0x0D41, 0x0D44 }, { 0x0D4D, 0x0D4D }, { 0x0D62, 0x0D63 }, { 0x0D81, 0x0D81 },
+    { 0x0DCA, 0x0DCA }, { 0x0DD2, 0x0DD4 }, { 0x0DD6, 0x0DD6 }, { 0x0E31, 0x0E31 }, { 0x0E34, 0x0E3A },
+    { 0x0E47, 0x0E4E }, { 0x0EB1, 0x0EB1 }, { 0x0EB4, 0x0EBC }, { 0x0EC8, 0x0ECE }, { 0x0F18, 0x0F19 },
+    { 0x0F35, 0x0F35 }, { 0x0F37, 0x0F37 }, { 0x0F39, 0x0F39 }, { 0x0F71, 0x0F7E }, { 0x0F80, 0x0F84 },
+    { 0x0F86, 0x0F87 }, { 0x0F8D, 0x0F97 }, { 0x0F99, 0x0FBC }, { 0x0FC6, 0x0FC6 }, { 0x102D, 0x1030 },
+    { 0x1032, 0x1037 }, { 0x1039, 0x103A }, { 0x103D, 0x103E }, { 0x1058, 0x1059 }, { 0x105E, 0x1060 },
+    { 0x1071, 0x1074 }, { 0x1082, 0x1082 }, { 0x1085, 0x1086 }, { 0x108D, 0x108D }, { 0x109D, 0x109D },
+    { 0x1160, 0x11FF }, { 0x135D, 0x135F }, { 0x1712, 0x1714 }, { 0x1732, 0x1733 }, { 0x1752, 0x1753 },
+    { 0x1772, 0x1773 }, { 0x17B4, 0x17B5 }, { 0x17B7, 0x17BD }, { 0x17C6, 0x17C6 }, { 0x17C9, 0x17D3 },
+    { 0x17DD, 0x17DD }, { 0x180B, 0x180F }, { 0x1885, 0x1886 }, { 0x18A9, 0x18A9 }, { 0x1920, 0x1922 },
+    { 0x1927, 0x1928 }, { 0x1932, 0x1932 }, { 0x1939, 0x193B }, { 0x1A17, 0x1A18 }, { 0x1A1B, 0x1A1B },
+    { 0x1A56, 0x1A56 }, { 0x1A58, 0x1A5E }, { 0x1A60, 0x1A60 }, { 0x1A62, 0x1A62 }, { 0x1A65, 0x1A6C },
+    { 0x1A73, 0x1A7C }, { 0x1A7F, 0x1A7F }, { 0x1AB0, 0x1ACE }, { 0x1B00, 0x1B03 }, { 0x1B34, 0x1B34 },
+    { 0x1B36, 0x1B3A }, { 0x1B3C, 0x1B3C }, { 0x1B42, 0x1B42 }, { 0x1B6B, 0x1B73 }, { 0x1B80, 0x1B81 },
+    { 0x1BA2, 0x1BA5 }, { 0x1BA8, 0x1BA9 }, { 0x1BAB, 0x1BAD }, { 0x1BE6, 0x1BE6 }, { 0x1BE8, 0x1BE9 },
+    { 0x1BED, 0x1BED }, { 0x1BEF, 0x1BF1 }, { 0x1C2C, 0x1C33 }, { 0x1C36, 0x1C37 }, { 0x1CD0, 0x1CD2 },
+    { 0x1CD4, 0x1CE0 }, { 0x1CE2, 0x1CE8 }, { 0x1CED, 0x1CED }, { 0x1CF4, 0x1CF4 }, { 0x1CF8, 0x1CF9 },
+    { 0x1DC0, 0x1DFF }, { 0x200B, 0x200F }, { 0x202A, 0x202E }, { 0x2060, 0x2064 }, { 0x206A, 0x206F },
+    { 0x20D0, 0x20F0 }, { 0x2CEF, 0x2CF1 }, { 0x2D7F, 0x2D7F }, { 0x2DE0, 0x2DFF }, { 0x302A, 0x302D },
+    { 0x3099, 0x309A }, { 0xA66F, 0xA672 }, { 0xA674, 0xA67D }, { 0xA69E, 0xA69F }, { 0xA6F0, 0xA6F1 },
+    { 0xA802, 0xA802 }, { 0xA806, 0xA806 }, { 0xA80B, 0xA80B }, { 0xA825, 0xA826 }, { 0xA82C, 0xA82C },
+    { 0xA8C4, 0xA8C5 }, { 0xA8E0, 0xA8F1 }, { 0xA8FF, 0xA8FF }, { 0xA926, 0xA92D }, { 0xA947, 0xA951 },
+    { 0xA980, 0xA982 }, { 0xA9B3, 0xA9B3 }, { 0xA9B6, 0xA9B9 }, { 0xA9BC, 0xA9BD }, { 0xA9E5, 0xA9E5 },
+    { 0xAA29, 0xAA2E }, { 0xAA31, 0xAA32 }, { 0xAA35, 0xAA36 }, { 0xAA43, 0xAA43 }, { 0xAA4C, 0xAA4C },
+    { 0xAA7C, 0xAA7C }, { 0xAAB0, 0xAAB0 }, { 0xAAB2, 0xAAB4 }, { 0xAAB7, 0xAAB8 }, { 0xAABE, 0xAABF },
+    { 0xAAC1, 0xAAC1 }, { 0xAAEC, 0xAAED }, { 0xAAF6, 0xAAF6 }, { 0xABE5, 0xABE5 }, { 0xABE8, 0xABE8 },
+    { 0xABED, 0xABED }, { 0xD7B0, 0xD7FF }, { 0xFB1E, 0xFB1E }, { 0xFE00, 0xFE0F }, { 0xFE20, 0xFE2F },
+    { 0xFEFF, 0xFEFF }, { 0xFFF9, 0xFFFB }, { 0x101FD, 0x101FD }, { 0x102E0, 0x102E0 }, { 0x10376, 0x1037A },
+    { 0x10A01, 0x10A03 }, { 0x10A05, 0x10A06 }, { 0x10A0C, 0x10A0F }, { 0x10A38, 0x10A3A }, { 0x10A3F, 0x10A3F },
+    { 0x10AE5, 0x10AE6 }, { 0x10D24, 0x10D27 }, { 0x10EAB, 0x10EAC }, { 0x10F46, 0x10F50 }, { 0x11001, 0x11001 },
+    { 0x11038, 0x11046 }, { 0x1107F, 0x11081 }, { 0x110B3, 0x110B6 }, { 0x110B9, 0x110BA }, { 0x11100, 0x11102 },
+    { 0x11127, 0x1112B }, { 0x1112D, 0x11134 }, { 0x11173, 0x11173 }, { 0x11180, 0x11181 }, { 0x111B6, 0x111BE },
+    { 0x1D167, 0x1D169 }, { 0x1D173, 0x1D182 }, { 0x1D185, 0x1D18B }, { 0x1D1AA, 0x1D1AD }, { 0x1D242, 0x1D244 },
+    { 0x1E000, 0x1E02A }, { 0x1E130, 0x1E136 }, { 0x1E2EC, 0x1E2EF }, { 0x1E8D0, 0x1E8D6 }, { 0x1E944, 0x1E94A },
+    { 0xE0001, 0xE0001 }, { 0xE0020, 0xE007F }, { 0xE0100, 0xE01EF },
+};
+
+// Code points with an East Asian Width of Wide or Fullwidth, which includes the emoji with a default
+// emoji presentation.
+constexpr CodePointRange WIDE_RANGES[] = {
+    { 0x1100, 0x115F }, { 0x231A, 0x231B }, { 0x2329, 0x232A }, { 0x23E9, 0x23EC }, { 0x23F0, 0x23F0 },
+    { 0x23F3, 0x23F3 }, { 0x25FD, 0x25FE }, { 0x2614, 0x2615 }, { 0x2648, 0x2653 }, { 0x267F, 0x267F },
+    { 0x2693, 0x2693 }, { 0x26A1, 0x26A1 }, { 0x26AA, 0x26AB }, { 0x26BD, 0x26BE }, { 0x26C4, 0x26C5 },
+    { 0x26CE, 0x26CE }, { 0x26D4, 0x26D4 }, { 0x26EA, 0x26EA }, { 0x26F2, 0x26F3 }, { 0x26F5, 0x26F5 },
+    { 0x26FA, 0x26FA }, { 0x26FD, 0x26FD }, { 0x2705, 0x2705 }, { 0x270A, 0x270B }, { 0x2728, 0x2728 },
+    { 0x274C, 0x274C }, { 0x274E, 0x274E }, { 0x2753, 0x2755 }, { 0x2757, 0x2757 }, { 0x2795, 0x2797 },
+    { 0x27B0, 0x27B0 }, { 0x27BF, 0x27BF }, { 0x2B1B, 0x2B1C }, { 0x2B50, 0x2B50 }, { 0x2B55, 0x2B55 },
+    { 0x2E80, 0x2E99 }, { 0x2E9B, 0x2EF3 }, { 0x2F00, 0x2FD5 }, { 0x2FF0, 0x2FFF }, { 0x3000, 0x303E },
+    { 0x3041, 0x3096 }, { 0x3099, 0x30FF }, { 0x3105, 0x312F }, { 0x3131, 0x318E }, { 0x3190, 0x31E5 },
+    { 0x31EF, 0x321E }, { 0x3220, 0x3247 }, { 0x3250, 0x4DBF }, { 0x4E00, 0xA48C }, { 0xA490, 0xA4C6 },
+    { 0xA960, 0xA97C }, { 0xAC00, 0xD7A3 }, { 0xF900, 0xFAFF }, { 0xFE10, 0xFE19 }, { 0xFE30, 0xFE52 },
+    { 0xFE54, 0xFE66 }, { 0xFE68, 0xFE6B }, { 0xFF01, 0xFF60 }, { 0xFFE0, 0xFFE6 }, { 0x16FE0, 0x16FE4 },
+    { 0x16FF0, 0x16FF1 }, { 0x17000, 0x187F7 }, { 0x18800, 0x18CD5 }, { 0x18D00, 0x18D08 }, { 0x1AFF0, 0x1AFF3 },
+    { 0x1AFF5, 0x1AFFB }, { 0x1AFFD, 0x1AFFE }, { 0x1B000, 0x1B122 }, { 0x1B132, 0x1B132 }, { 0x1B150, 0x1B152 },
+    { 0x1B155, 0x1B155 }, { 0x1B164, 0x1B167 }, { 0x1B170, 0x1B2FB }, { 0x1F004, 0x1F004 }, { 0x1F0CF, 0x1F0CF },
+    { 0x1F18E, 0x1F18E }, { 0x1F191, 0x1F19A }, { 0x1F200, 0x1F202 }, { 0x1F210, 0x1F23B }, { 0x1F240, 0x1F248 },
+    { 0x1F250, 0x1F251 }, { 0x1F260, 0x1F265 }, { 0x1F300, 0x1F320 }, { 0x1F32D, 0x1F335 }, { 0x1F337, 0x1F37C },
+    { 0x1F37E, 0x1F393 }, { 0x1F3A0, 0x1F3CA }, { 0x1F3CF, 0x1F3D3 }, { 0x1F3E0, 0x1F3F0 }, { 0x1F3F4, 0x1F3F4 },
+    { 0x1F3F8, 0x1F43E }, { 0x1F440, 0x1F440 }, { 0x1F442, 0x1F4FC }, { 0x1F4FF, 0x1F53D }, { 0x1F54B, 0x1F54E },
+    { 0x1F550, 0x1F567 }, { 0x1F57A, 0x1F57A }, { 0x1F595, 0x1F596 }, { 0x1F5A4, 0x1F5A4 }, { 0x1F5FB, 0x1F64F },
+    { 0x1F680, 0x1F6C5 }, { 0x1F6CC, 0x1F6CC }, { 0x1F6D0, 0x1F6D2 }, { 0x1F6D5, 0x1F6D7 }, { 0x1F6DC, 0x1F6DF },
+    { 0x1F6EB, 0x1F6EC }, { 0x1F6F4, 0x1F6FC }, { 0x1F7E0, 0x1F7EB }, { 0x1F7F0, 0x1F7F0 }, { 0x1F90C, 0x1F93A },
+    { 0x1F93C, 0x1F945 }, { 0x1F947, 0x1F9FF }, { 0x1FA70, 0x1FA7C }, { 0x1FA80, 0x1FA89 }, { 0x1FA8F, 0x1FAC6 },
+    { 0x1FACE, 0x1FADC }, { 0x1FADF, 0x1FAE9 }, { 0x1FAF0, 0x1FAF8 }, { 0x20000, 0x2FFFD }, { 0x30000, 0x3FFFD },
+};
+
+constexpr char32_t MAX_CODE_POINT = 0x10FFFF;
+constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// The first stage maps every block of 256 code points to one of the distinct blocks of the second
+// stage, which stores 2 bits of width per code point. Most blocks are entirely narrow or wide, so
+// only a few hundred distinct blocks remain.
+constexpr size_t WIDTH_BLOCK_BITS = 8;
+constexpr size_t WIDTH_BLOCK_SIZE = size_t{ 1 } << WIDTH_BLOCK_BITS;
+constexpr size_t WIDTH_BLOCK_COUNT = (MAX_CODE_POINT + 1) / WIDTH_BLOCK_SIZE;
+constexpr size_t MAX_DISTINCT_BLOCKS = 256;
+
+using WidthBlock = std::array<uint64_t, WIDTH_BLOCK_SIZE * 2 / 64>;
+
+struct WidthTable {
+    std::array<uint8_t, WIDTH_BLOCK_COUNT> block_indices;
+    std::array<WidthBlock, MAX_DISTINCT_BLOCKS> blocks;
+    size_t block_count;
+};
+
+constexpr void set_width(WidthBlock& block, const size_t offset, const uint64_t width) {
+    const auto shift = offset % 32 * 2;
+    block[offset / 32] = (block[offset / 32] & ~(uint64_t{ 0b11 } << shift)) | (width << shift);
+}
+
+// The blocks are visited in ascending order and the ranges are sorted, so the cursor skips every range
+// that ended before the current block once and stops at the first range after it.
+template <size_t N>
+constexpr void apply_ranges(WidthBlock& block, const char32_t block_start, const CodePointRange (&ranges)[N], size_t& cursor, const uint64_t width) {
+    constexpr uint64_t repeat = 0x5555555555555555; // Bit pattern 01 for every code point of a word
+    const auto block_end = static_cast<char32_t>(block_start + WIDTH_BLOCK_SIZE - 1);
+
+    while (cursor < N && ranges[cursor].last < block_start) ++cursor;
+
+    for (auto index = cursor; index < N && ranges[index].first <= block_end; ++index) {
+        const auto [first, last] = ranges[index];
+
+        auto offset = static_cast<size_t>((first > block_start) ? first - block_start : 0);
+        const auto end = static_cast<size_t>((last < block_end) ? last - block_start : WIDTH_BLOCK_SIZE - 1) + 1;
+
+        while (offset < end) {
+            if (offset % 32 == 0 && offset + 32 <= end) {
+                block[offset / 32] = repeat * width;
+                offset += 32;
+            } else {
+                set_width(block, offset++, width);
+            }
+        }
+    }
+}
+
+consteval WidthTable make_width_table() {
+    WidthTable table{};
+
+    size_t previous = 0, wide_cursor = 0, zero_width_cursor = 0;
+    for (size_t block_index = 0; block_index < WIDTH_BLOCK_COUNT; ++block_index) {
+        const auto block_start = static_cast<char32_t>(block_index << WIDTH_BLOCK_BITS);
+
+        WidthBlock block{};
+        for (auto& word : block) word = 0x5555555555555555; // Width 1 for every code point
+        apply_ranges(block, block_start, WIDE_RANGES, wide_cursor, 2);
+        apply_ranges(block, block_start, ZERO_WIDTH_RANGES, zero_width_cursor, 0);
+
+        // Neighbouring blocks are usually equal, so the previous one is tried before searching all of them.
+        auto distinct = previous;
+        if (table.block_count == 0 || table.blocks[distinct] != block) {
+            distinct = 0;
+            while (distinct < table.block_count && table.blocks[distinct] != block) ++distinct;
+        }
+
+        if (distinct == table.block_count) {
+            if (distinct == MAX_DISTINCT_BLOCKS) throw "make_width_table(): too many distinct blocks";
+            table.blocks[table.block_count++] = block;
+        }
+
+        table.block_indices[block_index] = static_cast<uint8_t>(distinct);
+        previous = distinct;
+    }
+
+    return table;
+}
+
+constexpr auto WIDTH_TABLE = make_width_table();
+
+DecodedChar pretty_diagnostics::decode_utf8(const std::string_view input, const size_t index) {
+    constexpr DecodedChar invalid = { REPLACEMENT_CHARACTER, 1 };
+
+    const auto lead = static_cast<unsigned char>(input[index]);
+    if (lead <= 0x7F) return { lead, 1 };
+
+    size_t byte_count;
+    char32_t code_point, minimum;
+    if ((lead & 0xE0) == 0xC0) {
+        byte_count = 2, code_point = lead & 0x1F, minimum = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        byte_count = 3, code_point = lead & 0x0F, minimum = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        byte_count = 4, code_point = lead & 0x07, minimum = 0x10000;
+    } else {
+        return invalid;
+    }
+
+    if (index + byte_count > input.size()) return invalid;
+
+    for (size_t offset = 1; offset < byte_count; ++offset) {
+        const auto continuation = static_cast<unsigned char>(input[index + offset]);
+        if ((continuation & 0xC0) != 0x80) return invalid;
+
+        code_point = (code_point << 6) | (continuation & 0x3F);
+    }
+
+    if (code_point < minimum || code_point > MAX_CODE_POINT || (code_point >= 0xD800 && code_point <= 0xDFFF)) return invalid;
+
+    return { code_point, byte_count };
+}
+
+size_t pretty_diagnostics::codepoint_width(const char32_t code_point) {
+    if (code_point > MAX_CODE_POINT) return 1;
+
+    const auto& block = WIDTH_TABLE.blocks[WIDTH_TABLE.block_indices[code_point >> WIDTH_BLOCK_BITS]];
+    const auto offset = code_point & (WIDTH_BLOCK_SIZE - 1);
+
+    return (block[offset / 32] >> (offset % 32 * 2)) & 0b11;
+}
+
+bool pretty_diagnostics::is_grapheme_extender(const char32_t code_point) {
+    // Skin tone modifiers are wide on their own, but merge into the emoji they follow.
+    if (code_point >= 0x1F3FB && code_point <= 0x1F3FF) return true;
+
+    return codepoint_width(code_point) == 0;
+}
+
+static size_t code_units(const char32_t code_point, const ColumnUnit unit) {
+    return (unit == ColumnUnit::Utf16 && code_point > 0xFFFF) ? 2 : 1;
+}
+
+size_t pretty_diagnostics::to_column(const std::string_view line, const size_t byte_column, const ColumnUnit unit) {
+    switch (unit) {
+        case ColumnUnit::Byte: return std::min(byte_column, line.size());
+        case ColumnUnit::Visual: return to_visual_column(line, byte_column);
+        case ColumnUnit::CodePoint:
+        case ColumnUnit::Utf16:
+        default: break;
+    }
+
+    size_t column = 0;
+    for (size_t index = 0; index < byte_column && index < line.size();) {
+        // Every ASCII character is a single code point and UTF-16 code unit.
+        if (const auto run = ascii_prefix_length(line.substr(index, byte_column - index)); run > 0) {
+            column += run;
+            index += run;
+            continue;
+        }
+
+        const auto [code_point, byte_count] = decode_utf8(line, index);
+        column += code_units(code_point, unit);
+        index += byte_count;
+    }
+
+    return column;
+}
+
+size_t pretty_diagnostics::from_column(const std::string_view line, const size_t column, const ColumnUnit unit) {
+    switch (unit) {
+        case ColumnUnit::Byte: return std::min(column, line.size());
+        case ColumnUnit::Visual: return from_visual_column(line, column);
+        case ColumnUnit::CodePoint:
+        case ColumnUnit::Utf16:
+        default: break;
+    }
+
+    size_t current_column = 0;
+    size_t byte_column = 0;
+    while (byte_column < line.size() && current_column < column) {
+        if (const auto run = ascii_prefix_length(line.substr(byte_column, column - current_column)); run > 0) {
+            byte_column += run;
+            current_column += run;
+            continue;
+        }
+
+        const auto [code_point, byte_count] = decode_utf8(line, byte_column);
+
+        const auto units = code_units(code_point, unit);
+        if (current_column + units > column) break;
+
+        byte_column += byte_count;
+        current_column += units;
+    }
+
+    return byte_column;
+}
+
+size_t pretty_diagnostics::convert_column(const std::string_view line, const size_t column, const ColumnUnit from, const ColumnUnit to) {
+    return to_column(line, from_column(line, column, from), to);
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
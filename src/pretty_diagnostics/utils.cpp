@@ -1,8 +1,23 @@
 #include "pretty_diagnostics/utils.hpp"
+#include "pretty_diagnostics/line_index.hpp"
+#include "pretty_diagnostics/unicode.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <iostream>
 #include <limits>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#define PRETTY_DIAGNOSTICS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PRETTY_DIAGNOSTICS_AVX2
+#include <immintrin.h>
+#endif
+
 #ifdef _WIN32
 #include <windows.h>
 #else
@@ -92,41 +107,114 @@ size_t pretty_diagnostics::get_stream_width(const std::ostream& stream) {
 #endif
 }
 
-VisualChar pretty_diagnostics::get_visual_char(const std::string_view input, const size_t index) {
-    if (index >= input.size()) {
-        return { 0, 0 };
+#ifdef PRETTY_DIAGNOSTICS_AVX2
+__attribute__((target("avx2"))) static size_t ascii_prefix_length_avx2(const char* data, const size_t size) {
+    size_t index = 0;
+    for (; index + 32 <= size; index += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(chunk));
+        if (mask != 0) return index + std::countr_zero(mask);
     }
 
-    const unsigned char current = input[index];
+    return index;
+}
+#endif
 
-    // ASCII
-    if (current <= 0x7F) {
-        return { 1, 1 };
+size_t pretty_diagnostics::ascii_prefix_length(const std::string_view input) {
+    size_t index = 0;
+
+#ifdef PRETTY_DIAGNOSTICS_AVX2
+    static const auto has_avx2 = is_kernel_supported(ScanKernel::AVX2);
+    if (has_avx2 && input.size() >= 32) {
+        index = ascii_prefix_length_avx2(input.data(), input.size());
+        if (index < input.size() && static_cast<unsigned char>(input[index]) > 0x7F) return index;
+    }
+#endif
+
+#ifdef PRETTY_DIAGNOSTICS_SSE2
+    for (; index + 16 <= input.size(); index += 16) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + index));
+
+        // The sign bit of every byte is set exactly for the bytes that are not ASCII.
+        const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(chunk));
+        if (mask != 0) return index + std::countr_zero(mask);
+    }
+#endif
+
+    for (; index < input.size(); ++index) {
+        if (static_cast<unsigned char>(input[index]) > 0x7F) break;
     }
 
-    // 2-byte UTF-8
-    if ((current & 0xE0) == 0xC0 && index + 1 < input.size()) {
-        return { 1, 2 };
+    return index;
+}
+
+// An ASCII character is a character of its own, unless a combining character follows it. So the last byte
+// of a run is left to `get_visual_char()`, which keeps the fast paths in line with decoding every character.
+// The scan stops one byte behind the limit, which is just enough to tell whether the last counted byte is followed.
+static size_t ascii_run(const std::string_view input, const size_t index, const size_t limit = std::string_view::npos) {
+    const auto run = ascii_prefix_length(input.substr(index, std::min(limit, input.size() - index - 1) + 1));
+    return std::min((run > 0 && index + run < input.size()) ? run - 1 : run, limit);
+}
+
+static bool is_regional_indicator(const char32_t code_point) {
+    return code_point >= 0x1F1E6 && code_point <= 0x1F1FF;
+}
+
+VisualChar pretty_diagnostics::get_visual_char(const std::string_view input, const size_t index) {
+    constexpr char32_t ZERO_WIDTH_JOINER = 0x200D;
+    constexpr char32_t EMOJI_PRESENTATION_SELECTOR = 0xFE0F;
+
+    if (index >= input.size()) {
+        return { 0, 0 };
     }
 
-    // 3-byte UTF-8
-    if ((current & 0xF0) == 0xE0 && index + 2 < input.size()) {
-        return { 2, 3 };
+    // ASCII followed by ASCII
+    const auto current = static_cast<unsigned char>(input[index]);
+    if (current <= 0x7F && (index + 1 == input.size() || static_cast<unsigned char>(input[index + 1]) <= 0x7F)) {
+        return { 1, 1 };
     }
 
-    // 4-byte UTF-8 (emoji, etc.)
-    if ((current & 0xF8) == 0xF0 && index + 3 < input.size()) {
-        return { 2, 4 };
+    const auto [code_point, byte_count] = decode_utf8(input, index);
+    auto width = codepoint_width(code_point);
+    auto pending_flag = is_regional_indicator(code_point);
+
+    // Extends the character by everything that attaches to it: combining marks, variation selectors,
+    // skin tones, the second half of a flag and emoji that are joined by a zero width joiner.
+    auto end = index + byte_count;
+    while (end < input.size()) {
+        const auto next = decode_utf8(input, end);
+
+        if (next.code_point == ZERO_WIDTH_JOINER && width == 2) {
+            end += next.byte_count;
+            if (end < input.size()) end += decode_utf8(input, end).byte_count;
+        } else if (next.code_point == EMOJI_PRESENTATION_SELECTOR) {
+            width = 2;
+            end += next.byte_count;
+        } else if (pending_flag && is_regional_indicator(next.code_point)) {
+            width = 2;
+            pending_flag = false;
+            end += next.byte_count;
+        } else if (is_grapheme_extender(next.code_point)) {
+            end += next.byte_count;
+        } else {
+            break;
+        }
     }
 
-    // Invalid or truncated UTF-8
-    return { 1, 1 };
+    return { width, end - index };
 }
 
 size_t pretty_diagnostics::visual_width(const std::string_view input) {
     size_t visual_width = 0;
 
     for (size_t index = 0; index < input.size();) {
+        if (const auto run = ascii_run(input, index); run > 0) {
+            visual_width += run;
+            index += run;
+            continue;
+        }
+
         auto [width, byte_count] = get_visual_char(input, index);
         visual_width += width;
         index += byte_count;
@@ -139,6 +227,12 @@ size_t pretty_diagnostics::to_visual_column(const std::string_view line, const s
     size_t visual_column = 0;
 
     for (size_t index = 0; index < byte_column && index < line.size();) {
+        if (const auto run = ascii_run(line, index, byte_column - index); run > 0) {
+            visual_column += run;
+            index += run;
+            continue;
+        }
+
         auto [width, byte_count] = get_visual_char(line, index);
         visual_column += width;
         index += byte_count;
@@ -152,6 +246,12 @@ size_t pretty_diagnostics::from_visual_column(const std::string_view line, const
     size_t byte_column = 0;
 
     while (byte_column < line.size() && current_column < visual_column) {
+        if (const auto run = ascii_run(line, byte_column, visual_column - current_column); run > 0) {
+            byte_column += run;
+            current_column += run;
+            continue;
+        }
+
         auto [width, byte_count] = get_visual_char(line, byte_column);
 
         if (current_column + width > visual_column) {
@@ -0,0 +1,5 @@
+#define SQUARE(x) ((x) * (x))
+
+int main() {
+    return SQUARE(1 + 2);
+}
@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <fstream>
 
+#include "pretty_diagnostics/expansion_source.hpp"
 #include "pretty_diagnostics/renderer.hpp"
 
 #include "../../snapshot/snapshot.hpp"
@@ -141,6 +142,39 @@ TEST(Renderer, UnicodeWrapRender) {
     EXPECT_SNAPSHOT_EQ(file_name, snapshot_path, stream.str());
 }
 
+TEST(Renderer, ExpansionRender) {
+    const auto snapshot_path = SNAPSHOTS_DIRECTORY / "05-expansion.snapshot";
+    const auto file_path = SNAPSHOTS_DIRECTORY / "05-expansion.c";
+
+    const auto file_name = file_path.filename().stem().string();
+    const auto file_source = std::make_shared<FileSource>(file_path, TEST_PATH);
+
+    // The body of SQUARE(1 + 2) maps to the invocation, its arguments are copied from the invocation.
+    const auto invocation = file_source->contents().find("SQUARE(1 + 2)");
+    const auto argument = invocation + 7;
+
+    const auto expansion = std::make_shared<ExpansionSource>("((1 + 2) * (1 + 2))", "<expansion of SQUARE>");
+    expansion->map(0, 2, file_source, invocation, invocation + 13);
+    expansion->map(2, 7, file_source, argument, argument + 5);
+    expansion->map(7, 12, file_source, invocation, invocation + 13);
+    expansion->map(12, 17, file_source, argument, argument + 5);
+    expansion->map(17, 19, file_source, invocation, invocation + 13);
+
+    const auto report = Report::Builder()
+                        .severity(Severity::Warning)
+                        .message("The argument of SQUARE is evaluated twice")
+                        .label("Evaluated here", { expansion, 2, 7 })
+                        .label("And here again", { expansion, 12, 17 })
+                        .help("Store the argument in a variable first.")
+                        .build();
+
+    auto renderer = TextRenderer(report);
+    auto stream = std::ostringstream();
+    report.render(renderer, stream);
+
+    EXPECT_SNAPSHOT_EQ(file_name, snapshot_path, stream.str());
+}
+
 // BSD 3-Clause License
 //
 // Copyright (c) 2025, Timo Behrend
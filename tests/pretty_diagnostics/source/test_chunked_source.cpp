@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "pretty_diagnostics/chunked_source.hpp"
+#include "pretty_diagnostics/span.hpp"
+
+using namespace pretty_diagnostics;
+
+static const auto SNAPSHOTS_DIRECTORY = std::filesystem::path(TEST_PATH) / "pretty_diagnostics" / "source" / "snapshots";
+
+TEST(ChunkedSource, MatchesFileSource) {
+    const auto file_path = SNAPSHOTS_DIRECTORY / "01-source.c";
+
+    const auto file_source = std::make_shared<FileSource>(file_path, TEST_PATH);
+
+    // Windows smaller than a line and a tiny budget, so almost every access has to read and evict.
+    for (const size_t window_size : { 1, 7, 64, 4096 }) {
+        const auto chunked_source = std::make_shared<ChunkedFileSource>(file_path, TEST_PATH, WindowConfig{ window_size, 2 });
+
+        ASSERT_EQ(chunked_source->path(), file_source->path());
+        ASSERT_EQ(chunked_source->size(), file_source->size());
+        ASSERT_EQ(chunked_source->line_count(), file_source->line_count());
+        ASSERT_FALSE(chunked_source->has_line(file_source->line_count()));
+
+        for (size_t index = 0; index <= file_source->size(); ++index) {
+            ASSERT_EQ(chunked_source->from_index(index), file_source->from_index(index));
+        }
+
+        for (size_t line = 0; line < file_source->line_count(); ++line) {
+            ASSERT_EQ(chunked_source->line(line), file_source->line(line));
+            ASSERT_EQ(chunked_source->from_coords(line, 0), file_source->from_coords(line, 0));
+        }
+
+        const auto span = Span(chunked_source, 37, 43);
+        ASSERT_EQ(span.substr(), "printf");
+        ASSERT_EQ(chunked_source->substr_view(chunked_source->from_index(0), chunked_source->from_index(chunked_source->size())),
+                  file_source->contents());
+        ASSERT_THROW((void) chunked_source->contents(), std::runtime_error);
+    }
+}
+
+TEST(ChunkedSource, ViewsArePinned) {
+    const auto file_path = SNAPSHOTS_DIRECTORY / "01-source.c";
+
+    const auto file_source = std::make_shared<FileSource>(file_path, TEST_PATH);
+    const auto chunked_source = std::make_shared<ChunkedFileSource>(file_path, TEST_PATH, WindowConfig{ 8, 1 });
+
+    // A walk over every row without a pin only keeps the window of the last view.
+    const auto walk = [&] {
+        for (size_t line = 0; line < file_source->line_count(); ++line) {
+            ASSERT_EQ(chunked_source->line_view(line), file_source->line_view(line));
+            const auto location = file_source->from_coords(line, 3);
+            ASSERT_EQ(chunked_source->column(location, ColumnUnit::Utf16), file_source->column(location, ColumnUnit::Utf16));
+        }
+    };
+
+    walk();
+    const auto walk_usage = chunked_source->memory_usage();
+
+    // Every line is requested while the earlier views are still held, which evicts their windows many times over.
+    {
+        const auto pin = chunked_source->pin();
+        const auto other_pin = chunked_source->pin();
+
+        std::vector<std::string_view> views;
+        for (size_t line = 0; line < file_source->line_count(); ++line) {
+            views.push_back(chunked_source->line_view(line));
+            (void) chunked_source->line(file_source->line_count() - 1 - line);
+        }
+
+        for (size_t line = 0; line < file_source->line_count(); ++line) {
+            ASSERT_EQ(views[line], file_source->line_view(line));
+        }
+
+        ASSERT_GT(chunked_source->memory_usage(), walk_usage + file_source->size() / 2);
+    }
+
+    // Dropping the last pin releases everything the views kept, apart from the window of the last view.
+    const auto window_capacity = std::string(8, ' ').capacity();
+    ASSERT_LE(chunked_source->memory_usage(), walk_usage + window_capacity);
+    walk();
+    ASSERT_LE(chunked_source->memory_usage(), walk_usage + window_capacity);
+}
+
+TEST(ChunkedSource, StreamsColumns) {
+    const auto file_path = std::filesystem::temp_directory_path() / "pretty_diagnostics_chunked_columns.txt";
+    const std::string contents = "a\u00E9\u4E2D\U0001F600b\r\n"
+                                 "e\u0301e\u0301x \U0001F1E9\U0001F1EA \u2764\uFE0F \U0001F468\u200D\U0001F469\u200D\U0001F467!\n"
+                                 "plain ascii line\r\n"
+                                 "\xFF\xC3 broken \xE4\xB8\r\n"
+                                 "\u4E2D\u4E2D\u4E2D";
+    {
+        std::ofstream file(file_path, std::ios::binary);
+        file << contents;
+    }
+
+    const auto string_source = StringSource(contents);
+    constexpr ColumnUnit units[] = { ColumnUnit::Byte, ColumnUnit::CodePoint, ColumnUnit::Utf16, ColumnUnit::Visual };
+
+    // Windows that cut through characters, graphemes and line breaks have to count the same columns as the whole line.
+    for (const size_t window_size : { 1, 2, 3, 5, 7, 16, 4096 }) {
+        const auto source = ChunkedFileSource(file_path, TEST_PATH, { .window_size = window_size, .max_windows = 2 });
+
+        for (size_t index = 0; index <= string_source.size(); ++index) {
+            ASSERT_EQ(source.from_index(index), string_source.from_index(index)) << window_size << " " << index;
+        }
+
+        for (size_t line = 0; line < string_source.line_count(); ++line) {
+            const auto line_size = string_source.line_view(line).size();
+            for (size_t column = 0; column <= line_size + 2; ++column) {
+                ASSERT_EQ(source.from_coords(line, column), string_source.from_coords(line, column));
+
+                for (const auto from : units) {
+                    for (const auto to : units) {
+                        ASSERT_EQ(source.convert_column(line, column, from, to), string_source.convert_column(line, column, from, to));
+                    }
+                }
+            }
+        }
+    }
+
+    std::filesystem::remove(file_path);
+}
+
+TEST(ChunkedSource, BoundedMemory) {
+    const auto file_path = std::filesystem::temp_directory_path() / "pretty_diagnostics_chunked_source.log";
+    {
+        std::ofstream file(file_path, std::ios::binary);
+        for (size_t line = 0; line < 200'000; ++line) {
+            file << "[trace] event " << line << " happened\n";
+        }
+    }
+
+    const auto source = ChunkedFileSource(file_path, TEST_PATH, { .window_size = 4096, .max_windows = 4 });
+    ASSERT_EQ(source.line(123'456), "[trace] event 123456 happened");
+    ASSERT_EQ(source.line(7), "[trace] event 7 happened");
+    ASSERT_EQ(source.from_index(source.size()).row(), 200'000);
+    ASSERT_EQ(source.line_count(), 200'001);
+
+    ASSERT_LT(source.memory_usage(), source.size() / 100);
+
+    std::filesystem::remove(file_path);
+}
+
+TEST(ChunkedSource, ChunkedFileSourceFailing) {
+    const auto file_path = SNAPSHOTS_DIRECTORY / "00-none.c";
+    EXPECT_THROW((ChunkedFileSource(file_path)), std::runtime_error);
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
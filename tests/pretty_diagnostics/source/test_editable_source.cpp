@@ -0,0 +1,149 @@
+#include "gtest/gtest.h"
+
+#include <random>
+
+#include "pretty_diagnostics/editable_source.hpp"
+#include "pretty_diagnostics/span.hpp"
+
+using namespace pretty_diagnostics;
+
+static void expect_same_source(const EditableSource& editable, const StringSource& expected) {
+    ASSERT_EQ(editable.contents(), expected.contents());
+    ASSERT_EQ(editable.size(), expected.size());
+    ASSERT_EQ(editable.line_count(), expected.line_count());
+
+    for (size_t index = 0; index <= expected.size(); ++index) {
+        ASSERT_EQ(editable.from_index(index), expected.from_index(index));
+    }
+
+    for (size_t line = 0; line < expected.line_count(); ++line) {
+        ASSERT_EQ(editable.line_view(line), expected.line_view(line));
+        ASSERT_EQ(editable.from_coords(line, 1), expected.from_coords(line, 1));
+    }
+}
+
+TEST(EditableSource, EditsMatchStringSource) {
+    std::string contents = "int main() {\n    return 0;\r\n}\n";
+    auto source = EditableSource(contents);
+
+    const std::string fragments[] = { "", "x", "\n", "äö\n", "\r\n", "🚀 rocket", "line\nline\nline" };
+
+    size_t applied_edits = 0;
+    std::mt19937 random(1337);
+    for (size_t edit = 0; edit < 300; ++edit) {
+        const auto first = std::uniform_int_distribution<size_t>(0, contents.size())(random);
+        const auto second = std::uniform_int_distribution<size_t>(0, contents.size())(random);
+        const auto start = std::min(first, second), end = std::min(std::max(first, second), start + 8);
+        const auto& replacement = fragments[random() % std::size(fragments)];
+
+        source.edit(start, end, replacement);
+        contents.replace(start, end - start, replacement);
+        if (start != end || !replacement.empty()) ++applied_edits;
+
+        expect_same_source(source, StringSource(contents));
+    }
+
+    ASSERT_EQ(source.version(), applied_edits);
+    ASSERT_GT(source.piece_count(), 1);
+}
+
+TEST(EditableSource, SnapshotKeepsVersion) {
+    auto source = EditableSource("let x = 1;\nlet y = 2;\n");
+
+    const auto snapshot = source.snapshot();
+    const auto span = Span(snapshot, 4, 5);
+
+    source.edit(0, 0, "// header\n");
+    source.edit(source.from_coords(2, 4), source.from_coords(2, 5), "z");
+
+    ASSERT_EQ(span.substr(), "x");
+    ASSERT_EQ(span.start().row(), 0);
+    ASSERT_EQ(snapshot->line(1), "let y = 2;");
+
+    ASSERT_EQ(source.line(0), "// header");
+    ASSERT_EQ(source.line(2), "let z = 2;");
+    ASSERT_EQ(source.version(), snapshot->version() + 2);
+}
+
+TEST(EditableSource, TypingMergesPieces) {
+    auto source = EditableSource("fn main() {}\n");
+    std::string contents = source.contents();
+
+    // Typing in the middle of the text splits a piece with every keystroke.
+    for (size_t keystroke = 0; keystroke < 10'000; ++keystroke) {
+        const auto position = 11 + keystroke / 2;
+        const auto character = (keystroke % 40 == 39) ? "\n" : "a";
+
+        source.edit(position, position, character);
+        contents.insert(position, character);
+    }
+
+    ASSERT_LE(source.piece_count(), 4096);
+    ASSERT_EQ(source.contents(), contents);
+    ASSERT_EQ(source.line_count(), StringSource(contents).line_count());
+}
+
+TEST(EditableSource, ViewsShareRowCopies) {
+    auto source = EditableSource("let x = 1;\nlet y = 2;\n");
+    source.edit(4, 5, "value");
+
+    // The first row now spans three pieces, every range within it is served from a single copy of the row.
+    const auto line = source.line_view(0);
+    ASSERT_EQ(line, "let value = 1;");
+
+    for (size_t start = 0; start < line.size(); ++start) {
+        for (auto end = start; end <= line.size(); ++end) {
+            const auto view = source.substr_view(source.from_index(start), source.from_index(end));
+            ASSERT_EQ(view, line.substr(start, end - start));
+            if (start < 4 && end > 9) {
+                ASSERT_EQ(view.data(), line.data() + start);
+            }
+        }
+    }
+
+    ASSERT_EQ(source.substr_view(source.from_index(8), source.from_index(20)), "e = 1;\nlet y");
+}
+
+TEST(EditableSource, EmptyAndInvalid) {
+    auto source = EditableSource("");
+    ASSERT_EQ(source.line_count(), 1);
+    ASSERT_EQ(source.line(0), "");
+    ASSERT_EQ(source.piece_count(), 0);
+
+    source.edit(0, 0, "abc");
+    source.edit(0, 3, "");
+    ASSERT_EQ(source.contents(), "");
+    ASSERT_EQ(source.piece_count(), 0);
+
+    EXPECT_THROW(source.edit(0, 1, "x"), std::runtime_error);
+    EXPECT_THROW((void) source.line(1), std::runtime_error);
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+
+#include "pretty_diagnostics/expansion_source.hpp"
+
+using namespace pretty_diagnostics;
+
+TEST(ExpansionSource, MapsCopiedAndExpandedRanges) {
+    const auto file = std::make_shared<StringSource>("#define ADD(a, b) a + b\nint x = ADD(1, 2);\n", "main.c");
+    const auto invocation = file->contents().find("ADD(1, 2)");
+
+    // "1 + 2": the operands are copied from the arguments, the operator comes from the macro body.
+    const auto expansion = std::make_shared<ExpansionSource>("1 + 2", "<expansion>");
+    expansion->map(0, 1, file, invocation + 4, invocation + 5);
+    expansion->map(1, 4, file, invocation, invocation + 9);
+    expansion->map(4, 5, file, invocation + 7, invocation + 8);
+
+    ASSERT_EQ(expansion->mapping_count(), 3);
+    ASSERT_EQ(expansion->find(2)->start, 1);
+    ASSERT_EQ(expansion->find(2)->parent, file);
+    ASSERT_FALSE(expansion->find(5).has_value());
+
+    const auto operand = expansion->to_parent(Span(expansion, 4, 5));
+    ASSERT_EQ(file->substr(operand->start(), operand->end()), "2");
+
+    const auto operator_span = expansion->to_parent(Span(expansion, 2, 3));
+    ASSERT_EQ(file->substr(operator_span->start(), operator_span->end()), "ADD(1, 2)");
+
+    // A span over several mappings of the same parent reaches from the first to the last of them.
+    const auto whole = expansion->to_parent(Span(expansion, 0, 5));
+    ASSERT_EQ(file->substr(whole->start(), whole->end()), "1, 2");
+
+    ASSERT_THROW((void) expansion->to_parent(Span(file, 0, 1)), std::runtime_error);
+    ASSERT_THROW(expansion->map(3, 4, file, 0, 1), std::runtime_error);
+    ASSERT_THROW(expansion->map(5, 6, file, 0, 1), std::runtime_error);
+    ASSERT_THROW(expansion->map(5, 5, nullptr, 0, 0), std::runtime_error);
+}
+
+TEST(ExpansionSource, FollowsNestedExpansions) {
+    const auto file = std::make_shared<StringSource>("#define ONE 1\n#define TWO (ONE + ONE)\nint x = TWO;\n", "main.c");
+    const auto use = file->contents().find("TWO;");
+    const auto body = file->contents().find("(ONE + ONE)");
+
+    // TWO expands to "(ONE + ONE)", which is copied from its definition, and ONE expands to "1".
+    const auto outer = std::make_shared<ExpansionSource>("(ONE + ONE)", "<expansion of TWO>");
+    outer->map(0, 11, file, body, body + 11);
+
+    const auto inner = std::make_shared<ExpansionSource>("(1 + 1)", "<expansion of ONE>");
+    inner->map(0, 1, outer, 0, 1);
+    inner->map(1, 2, outer, 1, 4);
+    inner->map(2, 5, outer, 4, 7);
+    inner->map(5, 6, outer, 7, 10);
+    inner->map(6, 7, outer, 10, 11);
+
+    const auto chain = expansion_chain(Span(inner, 5, 6));
+    ASSERT_EQ(chain.size(), 2);
+    ASSERT_EQ(chain[0].source(), outer);
+    ASSERT_EQ(outer->substr(chain[0].start(), chain[0].end()), "ONE");
+    ASSERT_EQ(chain[1].source(), file);
+    ASSERT_EQ(file->substr(chain[1].start(), chain[1].end()), "ONE");
+    ASSERT_EQ(chain[1].start().index(), body + 7);
+
+    ASSERT_EQ(spelling_span(Span(inner, 5, 6)), chain[1]);
+    ASSERT_EQ(spelling_span(Span(file, use, use + 3)), Span(file, use, use + 3));
+    ASSERT_TRUE(expansion_chain(Span(file, use, use + 3)).empty());
+}
+
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include "pretty_diagnostics/region_source.hpp"
+#include "pretty_diagnostics/span.hpp"
+
+using namespace pretty_diagnostics;
+
+static const std::string HOST = "auto query = R\"(SELECT *\n  FROM users\n  WHERE name = 'Jürgen')\";\nrun(query);\n";
+
+TEST(RegionSource, MatchesCopiedRegion) {
+    const auto parent = std::make_shared<StringSource>(HOST, "host.cpp");
+    const auto start = HOST.find("SELECT"), end = HOST.find(")\";");
+
+    const auto region = RegionSource(parent, start, end);
+    const auto copy = StringSource(HOST.substr(start, end - start));
+
+    ASSERT_EQ(region.path(), "host.cpp");
+    ASSERT_EQ(region.contents_view(), copy.contents_view());
+    ASSERT_EQ(region.contents_view().data(), parent->contents_view().data() + start);
+    ASSERT_EQ(region.size(), copy.size());
+    ASSERT_EQ(region.line_count(), copy.line_count());
+
+    for (size_t index = 0; index <= copy.size(); ++index) {
+        ASSERT_EQ(region.from_index(index), copy.from_index(index));
+    }
+
+    for (size_t line = 0; line < copy.line_count(); ++line) {
+        ASSERT_EQ(region.line_view(line), copy.line_view(line));
+        ASSERT_EQ(region.line_start(line), copy.line_start(line));
+        ASSERT_EQ(region.from_coords(line, 3), copy.from_coords(line, 3));
+        ASSERT_EQ(region.from_coords(line, 100), copy.from_coords(line, 100));
+
+        for (size_t column = 0; column < 30; ++column) {
+            ASSERT_EQ(region.convert_column(line, column, ColumnUnit::Visual, ColumnUnit::Byte),
+                      copy.convert_column(line, column, ColumnUnit::Visual, ColumnUnit::Byte));
+            ASSERT_EQ(region.convert_column(line, column, ColumnUnit::Byte, ColumnUnit::Utf16),
+                      copy.convert_column(line, column, ColumnUnit::Byte, ColumnUnit::Utf16));
+        }
+    }
+}
+
+TEST(RegionSource, TranslatesLocations) {
+    const auto parent = std::make_shared<StringSource>(HOST, "host.cpp");
+    const auto start = HOST.find("SELECT"), end = HOST.find(")\";");
+    const auto region = std::make_shared<RegionSource>(parent, start, end, "query.sql");
+
+    const auto users = HOST.find("users");
+    const auto in_parent = parent->from_index(users);
+    const auto in_region = region->from_parent(in_parent);
+
+    ASSERT_EQ(in_region, region->from_coords(1, 7));
+    ASSERT_EQ(region->to_parent(in_region), in_parent);
+    ASSERT_EQ(region->to_parent(region->from_index(0)), parent->from_index(start));
+    ASSERT_EQ(region->to_parent(region->from_index(3)).column(), parent->from_index(start + 3).column());
+
+    ASSERT_TRUE(region->contains(parent->from_index(end)));
+    ASSERT_FALSE(region->contains(parent->from_index(end + 1)));
+    ASSERT_THROW((void) region->from_parent(parent->from_index(0)), std::runtime_error);
+
+    const auto span = Span(region, users - start, users - start + 5);
+    const auto parent_span = to_parent(span);
+    ASSERT_EQ(parent_span.source(), parent);
+    ASSERT_EQ(parent->substr(parent_span.start(), parent_span.end()), "users");
+    ASSERT_EQ(to_region(region, parent_span), span);
+
+    ASSERT_THROW((void) to_parent(parent_span), std::runtime_error);
+    ASSERT_THROW((RegionSource(parent, end, start)), std::runtime_error);
+    ASSERT_THROW((RegionSource(nullptr, 0, 0)), std::runtime_error);
+}
+
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -2,7 +2,9 @@
 
 #include <filesystem>
 #include <fstream>
+#include <vector>
 
+#include "pretty_diagnostics/editable_source.hpp"
 #include "pretty_diagnostics/source.hpp"
 
 #include "../../snapshot/snapshot.hpp"
@@ -26,11 +28,144 @@ TEST(Source, FileSourceWorking) {
     ASSERT_EQ(file_source->line(3), "    printf(\"Hello World!\\n\");");
 }
 
+TEST(Source, ViewsPointIntoContents) {
+    const auto file_path = SNAPSHOTS_DIRECTORY / "01-source.c";
+    const auto file_source = std::make_shared<FileSource>(file_path, TEST_PATH);
+
+    const auto contents = file_source->contents_view();
+    ASSERT_EQ(contents.data(), file_source->contents().data());
+
+    const auto line = file_source->line_view(3);
+    ASSERT_EQ(line, "    printf(\"Hello World!\\n\");");
+    ASSERT_EQ(line.data(), contents.data() + 33);
+
+    const auto substr = file_source->substr_view(file_source->from_index(37), file_source->from_index(43));
+    ASSERT_EQ(substr, "printf");
+    ASSERT_EQ(substr.data(), contents.data() + 37);
+
+    ASSERT_THROW((void) file_source->line_view(6), std::runtime_error);
+}
+
+TEST(Source, CopiesAndMovesRebindTheIndex) {
+    auto original = StringSource("int a;\nint b;\nint c;", "copy.c");
+
+    std::vector<StringSource> sources;
+    sources.push_back(original);
+    sources.push_back(std::move(original));
+    sources.emplace_back("x", "assigned.c");
+    sources.back() = sources.front();
+
+    for (const auto& source : sources) {
+        ASSERT_EQ(source.line_count(), 3);
+        ASSERT_EQ(source.line_view(1), "int b;");
+        ASSERT_EQ(source.line_view(1).data(), source.contents().data() + 7);
+    }
+}
+
+TEST(Source, CursorMatchesFromIndex) {
+    std::string contents;
+    for (size_t line = 0; line < 200; ++line) {
+        contents += (line % 5 == 0) ? "let 🚀 = \"äöü\";\r\n" : "let value = " + std::to_string(line) + ";\n";
+        if (line % 50 == 0) contents += std::string(30, '\n');
+    }
+
+    const auto source = StringSource(contents);
+
+    // Every index in order, then a sparse walk with large jumps and a few steps backwards.
+    auto cursor = LocationCursor(source);
+    for (size_t index = 0; index <= source.size(); ++index) {
+        ASSERT_EQ(cursor.locate(index), source.from_index(index));
+    }
+
+    for (const size_t index : { 5, 6, 1'000, 1'001, 3, 2'500, 2'400, 2'401, 0 }) {
+        ASSERT_EQ(cursor.locate(index), source.from_index(index));
+    }
+
+    ASSERT_THROW((void) cursor.locate(source.size() + 1), std::runtime_error);
+}
+
+TEST(Source, FromIndices) {
+    const auto file_path = SNAPSHOTS_DIRECTORY / "01-source.c";
+    const auto file_source = std::make_shared<FileSource>(file_path, TEST_PATH);
+
+    const std::vector<size_t> indices = { 0, 0, 10, 17, 37, 43, 44, 60, 78 };
+    const auto locations = file_source->from_indices(indices);
+
+    ASSERT_EQ(locations.size(), indices.size());
+    for (size_t index = 0; index < indices.size(); ++index) {
+        ASSERT_EQ(locations[index], file_source->from_index(indices[index]));
+    }
+
+    const std::vector<size_t> unsorted = { 10, 5 };
+    ASSERT_THROW((void) file_source->from_indices(unsorted), std::runtime_error);
+}
+
+TEST(Source, ColumnUnits) {
+    // "a" is one unit in everything, "é" two bytes, "中" three bytes and two visual columns, "😀" four bytes and two UTF-16 units.
+    const auto source = StringSource("plain ascii\na\u00E9\u4E2D\U0001F600b\n");
+    ASSERT_EQ(source.convert_column(1, 11, ColumnUnit::Byte, ColumnUnit::CodePoint), 5);
+    ASSERT_EQ(source.convert_column(1, 11, ColumnUnit::Byte, ColumnUnit::Utf16), 6);
+    ASSERT_EQ(source.convert_column(1, 11, ColumnUnit::Byte, ColumnUnit::Visual), 7);
+    ASSERT_EQ(source.convert_column(1, 5, ColumnUnit::Utf16, ColumnUnit::Byte), 10);
+    ASSERT_EQ(source.convert_column(1, 4, ColumnUnit::Utf16, ColumnUnit::Byte), 6);
+    ASSERT_EQ(source.convert_column(0, 5, ColumnUnit::Utf16, ColumnUnit::Visual), 5);
+
+    const auto location = source.from_unit_coords(1, 5, ColumnUnit::Utf16);
+    ASSERT_EQ(location, source.from_index(22));
+    ASSERT_EQ(source.column(location, ColumnUnit::Utf16), 5);
+    ASSERT_EQ(source.column(location, ColumnUnit::CodePoint), 4);
+
+    // Long rows go through the checkpoint tables of the line index, which have to agree with decoding the whole row.
+    std::string line;
+    for (size_t index = 0; index < 300; ++index) line += (index % 5 == 0) ? "\U0001F600" : (index % 7 == 0) ? "\u4E2D" : "x";
+
+    const auto indexed = StringSource(line);
+    const auto decoded = EditableSource(line);
+    constexpr ColumnUnit units[] = { ColumnUnit::Byte, ColumnUnit::CodePoint, ColumnUnit::Utf16, ColumnUnit::Visual };
+    for (size_t column = 0; column < line.size() + 4; column += 3) {
+        for (const auto from : units) {
+            for (const auto to : units) {
+                ASSERT_EQ(indexed.convert_column(0, column, from, to), decoded.convert_column(0, column, from, to));
+            }
+        }
+    }
+}
+
 TEST(Source, FileSourceFailing) {
     const auto file_path = SNAPSHOTS_DIRECTORY / "00-none.c";
     EXPECT_THROW((FileSource(file_path)), std::runtime_error);
 }
 
+TEST(Source, FileSourceWithResolver) {
+    const auto file_path = SNAPSHOTS_DIRECTORY / "01-source.c";
+    const auto resolver = PathResolver(TEST_PATH);
+
+    const auto file_source = FileSource(file_path, resolver);
+    ASSERT_EQ(file_source.path(), std::filesystem::relative(file_path, TEST_PATH));
+    ASSERT_EQ(file_source.contents(), FileSource(file_path, TEST_PATH).contents());
+
+    // The second source resolves the same path again, which is served from the cache.
+    const auto other_source = FileSource(file_path, resolver);
+    ASSERT_EQ(other_source.path(), file_source.path());
+    ASSERT_EQ(resolver.size(), 1);
+
+    EXPECT_THROW((FileSource(SNAPSHOTS_DIRECTORY / "00-none.c", resolver)), std::runtime_error);
+    EXPECT_THROW((FileSource(SNAPSHOTS_DIRECTORY, resolver)), std::runtime_error);
+}
+
+TEST(Source, PathResolverIsLexical) {
+    const auto resolver = PathResolver(TEST_PATH);
+    const auto working_path = std::filesystem::weakly_canonical(TEST_PATH);
+
+    ASSERT_EQ(resolver.working_path(), working_path);
+    ASSERT_EQ(resolver.display_path(working_path / "a" / ".." / "b" / "c.c"), "b/c.c");
+    ASSERT_EQ(resolver.display_path(working_path.parent_path() / "d.c"), "../d.c");
+    ASSERT_EQ(resolver.display_path(working_path / "missing" / "e.c"), "missing/e.c");
+
+    const auto relative_path = std::filesystem::path("f.c");
+    ASSERT_EQ(resolver.display_path(relative_path), (std::filesystem::current_path() / relative_path).lexically_relative(working_path));
+}
+
 // BSD 3-Clause License
 //
 // Copyright (c) 2025, Timo Behrend
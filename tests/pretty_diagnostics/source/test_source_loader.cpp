@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "pretty_diagnostics/source_loader.hpp"
+#include "pretty_diagnostics/source_manager.hpp"
+
+using namespace pretty_diagnostics;
+
+static const auto SNAPSHOTS_DIRECTORY = std::filesystem::path(TEST_PATH) / "pretty_diagnostics" / "source" / "snapshots";
+
+static std::vector<std::filesystem::path> write_files(const size_t count) {
+    const auto directory = std::filesystem::temp_directory_path() / "pretty_diagnostics_source_loader";
+    std::filesystem::create_directories(directory);
+
+    std::vector<std::filesystem::path> paths;
+    for (size_t index = 0; index < count; ++index) {
+        auto path = directory / ("file_" + std::to_string(index) + ".txt");
+
+        std::ofstream file(path, std::ios::binary);
+        for (size_t line = 0; line <= index; ++line) file << "file " << index << " line " << line << "\n";
+
+        paths.push_back(std::move(path));
+    }
+
+    return paths;
+}
+
+TEST(SourceLoader, LoadsConcurrently) {
+    const auto paths = write_files(16);
+
+    auto loader = SourceLoader({ .threads = 4, .working_path = TEST_PATH });
+    auto futures = loader.load(paths);
+    ASSERT_EQ(futures.size(), paths.size());
+
+    for (size_t index = 0; index < paths.size(); ++index) {
+        const auto source = futures[index].get();
+        const auto expected = FileSource(paths[index], TEST_PATH);
+
+        ASSERT_EQ(source->path(), expected.path());
+        ASSERT_EQ(source->contents(), expected.contents());
+        ASSERT_EQ(source->line_count(), index + 2);
+    }
+}
+
+TEST(SourceLoader, StoresErrors) {
+    auto loader = SourceLoader({ .threads = 2 });
+
+    auto missing = loader.load(SNAPSHOTS_DIRECTORY / "00-none.c");
+    auto present = loader.load(SNAPSHOTS_DIRECTORY / "01-source.c");
+
+    EXPECT_THROW((void) missing.get(), std::runtime_error);
+    ASSERT_FALSE(present.get()->contents().empty());
+}
+
+TEST(SourceLoader, OpenAllInterns) {
+    const auto paths = write_files(4);
+    auto manager = SourceManager({ .threads = 2, .working_path = TEST_PATH });
+
+    const auto opened = manager.open(paths[1]);
+
+    auto requested = paths;
+    requested.push_back(paths[0]);
+
+    const auto sources = manager.open_all(requested);
+    ASSERT_EQ(sources.size(), requested.size());
+    ASSERT_EQ(sources[1], opened);
+    ASSERT_EQ(sources[0], sources[4]);
+    ASSERT_EQ(manager.source_count(), paths.size());
+
+    for (size_t index = 0; index < paths.size(); ++index) {
+        const auto pin = sources[index]->pin();
+        ASSERT_EQ(sources[index]->contents(), FileSource(paths[index], TEST_PATH).contents());
+    }
+
+    const std::vector<std::filesystem::path> broken = { paths[2], SNAPSHOTS_DIRECTORY / "00-none.c" };
+    EXPECT_THROW((void) manager.open_all(broken), std::runtime_error);
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
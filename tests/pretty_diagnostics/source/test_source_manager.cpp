@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "pretty_diagnostics/renderer.hpp"
+#include "pretty_diagnostics/report.hpp"
+#include "pretty_diagnostics/source_manager.hpp"
+
+using namespace pretty_diagnostics;
+
+static const auto SNAPSHOTS_DIRECTORY = std::filesystem::path(TEST_PATH) / "pretty_diagnostics" / "source" / "snapshots";
+
+TEST(SourceManager, InternsByCanonicalPath) {
+    auto manager = SourceManager({ .working_path = TEST_PATH });
+
+    const auto first = manager.open(SNAPSHOTS_DIRECTORY / "01-source.c");
+    const auto second = manager.open(SNAPSHOTS_DIRECTORY / ".." / "snapshots" / "." / "01-source.c");
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(manager.source_count(), 1);
+
+    const auto file_source = FileSource(SNAPSHOTS_DIRECTORY / "01-source.c", TEST_PATH);
+    ASSERT_EQ(first->path(), file_source.path());
+    {
+        const auto pin = first->pin();
+        ASSERT_EQ(first->contents(), file_source.contents());
+    }
+    ASSERT_EQ(first->from_index(40), file_source.from_index(40));
+
+    const auto report = Report::Builder()
+                        .severity(Severity::Error)
+                        .message("Same file, different paths")
+                        .label("first", { first, 37, 43 })
+                        .label("second", { second, 44, 60 })
+                        .build();
+    ASSERT_EQ(report.file_groups().size(), 1);
+}
+
+TEST(SourceManager, EvictsUnderBudget) {
+    const auto directory = std::filesystem::temp_directory_path() / "pretty_diagnostics_source_manager";
+    std::filesystem::create_directories(directory);
+
+    for (const auto* name : { "a.txt", "b.txt", "c.txt" }) {
+        std::ofstream file(directory / name, std::ios::binary);
+        for (size_t line = 0; line < 1'000; ++line) file << name << " line " << line << "\n";
+    }
+
+    // Room for two of the three files, including their line indices.
+    const auto file_size = std::filesystem::file_size(directory / "a.txt");
+    auto manager = SourceManager({ .byte_budget = file_size * 3 });
+
+    const auto a = manager.open(directory / "a.txt");
+    const auto b = manager.open(directory / "b.txt");
+    ASSERT_TRUE(a->is_loaded());
+    ASSERT_TRUE(b->is_loaded());
+
+    (void) a->line(0);
+    const auto c = manager.open(directory / "c.txt");
+    ASSERT_TRUE(a->is_loaded());
+    ASSERT_FALSE(b->is_loaded());
+    ASSERT_TRUE(c->is_loaded());
+    ASSERT_LE(manager.resident_bytes(), file_size * 3);
+
+    // An evicted source is loaded again on its next access.
+    ASSERT_EQ(b->line(999), "b.txt line 999");
+    ASSERT_TRUE(b->is_loaded());
+    ASSERT_FALSE(a->is_loaded());
+    ASSERT_EQ(manager.source_count(), 3);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(SourceManager, ViewsPinSources) {
+    const auto directory = std::filesystem::temp_directory_path() / "pretty_diagnostics_source_manager_pins";
+    std::filesystem::create_directories(directory);
+
+    for (const auto* name : { "a.txt", "b.txt" }) {
+        std::ofstream file(directory / name, std::ios::binary);
+        for (size_t line = 0; line < 1'000; ++line) file << name << " line " << line << "\n";
+    }
+
+    // Room for a single file, so loading the second one would evict the first.
+    const auto file_size = std::filesystem::file_size(directory / "a.txt");
+    auto manager = SourceManager({ .byte_budget = file_size * 3 / 2 });
+
+    const auto a = manager.open(directory / "a.txt");
+    ASSERT_THROW((void) a->line_view(42), std::runtime_error);
+
+    auto pin = a->pin();
+    auto other_pin = a->pin();
+    const auto line = a->line_view(42);
+    ASSERT_TRUE(a->is_pinned());
+
+    const auto b = manager.open(directory / "b.txt");
+    ASSERT_EQ(b->line(7), "b.txt line 7");
+    ASSERT_TRUE(a->is_loaded());
+    ASSERT_EQ(line, "a.txt line 42");
+    ASSERT_EQ(line.data(), a->line_view(42).data());
+
+    // The source stays pinned as long as any of its pins is alive.
+    pin.reset();
+    ASSERT_TRUE(a->is_pinned());
+    ASSERT_EQ(a->line_view(43), "a.txt line 43");
+
+    // Dropping the last pin brings the sources back into their budget, afterward the source can be evicted again.
+    other_pin.reset();
+    ASSERT_FALSE(a->is_pinned());
+    ASSERT_FALSE(b->is_loaded());
+    ASSERT_LE(manager.resident_bytes(), file_size * 3 / 2);
+
+    ASSERT_EQ(b->line(8), "b.txt line 8");
+    ASSERT_FALSE(a->is_loaded());
+
+    // Rendering a report pins the source only while its lines are printed.
+    const auto report = Report::Builder().message("Pinned").label("Line", { a, a->line_start(3), a->line_start(3) + 5 }).build();
+    auto renderer = TextRenderer(report);
+    auto stream = std::ostringstream();
+    report.render(renderer, stream);
+    ASSERT_NE(stream.str().find("a.txt line 3"), std::string::npos);
+    ASSERT_FALSE(a->is_pinned());
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(SourceManager, ReleasesUnusedSources) {
+    auto manager = SourceManager();
+
+    {
+        const auto source = manager.open(SNAPSHOTS_DIRECTORY / "01-source.c");
+        ASSERT_EQ(manager.source_count(), 1);
+        ASSERT_GT(manager.resident_bytes(), 0);
+    }
+
+    ASSERT_EQ(manager.source_count(), 0);
+    ASSERT_EQ(manager.resident_bytes(), 0);
+
+    EXPECT_THROW((void) manager.open(SNAPSHOTS_DIRECTORY / "00-none.c"), std::runtime_error);
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "pretty_diagnostics/source_map.hpp"
+
+using namespace pretty_diagnostics;
+
+static constexpr auto ORIGINAL = "let total: number = add(1, 2);\nconsole.log(\"😀\", total);\n";
+static constexpr auto GENERATED = "var total = add(1, 2);\nconsole.log(\"😀\", total);\n";
+static constexpr auto MAP = R"({
+    "version": 3,
+    "file": "app.js",
+    "sourceRoot": "",
+    "sources": ["app.ts"],
+    "names": [],
+    "mappings": "AAAA,IAAI,MAAc,EAAE,U;AACpB,kBAAkB"
+})";
+
+TEST(SourceMap, DecodesSegments) {
+    const auto map = SourceMap::parse(MAP);
+
+    ASSERT_EQ(map.file(), "app.js");
+    ASSERT_EQ(map.sources(), std::vector<std::string>({ "app.ts" }));
+    ASSERT_EQ(map.segments().size(), 7);
+
+    const auto* segment = map.find(0, 15);
+    ASSERT_NE(segment, nullptr);
+    ASSERT_EQ(segment->generated_column, 12);
+    ASSERT_EQ(segment->original_column, 20);
+
+    // The segment with a single field ends the mapped range of the first row.
+    ASSERT_EQ(map.find(0, 22), nullptr);
+    ASSERT_EQ(map.find(1, 18)->original_row, 1);
+    ASSERT_EQ(map.find(2, 0), nullptr);
+
+    ASSERT_THROW((void) SourceMap::parse(R"({"version": 2, "sources": [], "mappings": ""})"), std::runtime_error);
+    ASSERT_THROW((void) SourceMap::parse(R"({"version": 3, "sources": [], "mappings": "AAAA"})"), std::runtime_error);
+    ASSERT_THROW((void) SourceMap::parse(R"({"version": 3, "sources": ["a"], "mappings": "AA!A"})"), std::runtime_error);
+    ASSERT_THROW((void) SourceMap::parse(R"({"version": 3, "sections": []})"), std::runtime_error);
+    ASSERT_THROW((void) SourceMap::parse(R"({"version": 3, "sources": ["a"], "mappings": ""} x)"), std::runtime_error);
+}
+
+TEST(SourceMap, TranslatesToOriginal) {
+    const auto original = std::make_shared<StringSource>(ORIGINAL, "app.ts");
+    const auto generated = std::make_shared<SourceMapSource>(GENERATED, SourceMap::parse(MAP), std::vector<std::shared_ptr<Source>>{ original }, "app.js");
+
+    const auto add = generated->original(generated->from_coords(0, 12));
+    ASSERT_TRUE(add.has_value());
+    ASSERT_EQ(add->source, original);
+    ASSERT_EQ(add->location, original->from_coords(0, 20));
+
+    // Columns of the source map count UTF-16 units, the emoji in front of "total" takes two of them.
+    const auto generated_total = std::string_view(GENERATED).rfind("total");
+    const auto span = generated->to_original(Span(generated, generated_total, generated_total + 5));
+    ASSERT_EQ(original->substr(span->start(), span->end()), "total");
+
+    const auto call = generated->to_original(Span(generated, 12, 21));
+    ASSERT_EQ(original->substr(call->start(), call->end()), "add(1, 2)");
+
+    // "var" and "let" have the same length, so the span keeps its extent.
+    const auto keyword = generated->to_original(Span(generated, 0, 3));
+    ASSERT_EQ(original->substr(keyword->start(), keyword->end()), "let");
+
+    ASSERT_FALSE(generated->original(generated->from_index(22)).has_value());
+    ASSERT_THROW((void) generated->to_original(Span(original, 0, 1)), std::runtime_error);
+    ASSERT_THROW((SourceMapSource(GENERATED, SourceMap::parse(MAP), {}, "app.js")), std::runtime_error);
+}
+
+TEST(SourceMap, OpensFromDisk) {
+    const auto directory = std::filesystem::temp_directory_path() / "pretty_diagnostics_source_map";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory / "src");
+
+    std::ofstream(directory / "app.js") << GENERATED;
+    std::ofstream(directory / "src" / "app.ts") << ORIGINAL;
+    std::ofstream(directory / "app.js.map") << R"({"version": 3, "sourceRoot": "src", "sources": ["app.ts", "gone.ts"],
+        "sourcesContent": [null, "embedded\n"], "mappings": "AAAA;ACAA"})";
+
+    const auto generated = SourceMapSource::open(directory / "app.js", {}, directory);
+    ASSERT_EQ(generated->path(), "app.js");
+    ASSERT_EQ(generated->originals().size(), 2);
+    ASSERT_EQ(generated->originals()[0]->path(), "src/app.ts");
+    ASSERT_EQ(generated->originals()[1]->contents(), "embedded\n");
+
+    const auto second_row = generated->original(generated->from_coords(1, 0));
+    ASSERT_EQ(second_row->source, generated->originals()[1]);
+
+    std::filesystem::remove_all(directory);
+}
+
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include "pretty_diagnostics/compact_span.hpp"
+#include "pretty_diagnostics/report.hpp"
+
+using namespace pretty_diagnostics;
+
+static const auto RESOURCES_DIRECTORY = std::filesystem::path(TEST_PATH) / "pretty_diagnostics" / "resources";
+
+TEST(CompactSpan, RoundTrip) {
+    const auto file_source = std::make_shared<FileSource>(RESOURCES_DIRECTORY / "01-main.c", TEST_PATH);
+    auto table = SourceTable();
+
+    const auto span = Span(file_source, 37, 43);
+    const auto compact = table.compact(span);
+    ASSERT_EQ(compact.source_id(), 0);
+    ASSERT_EQ(compact.start_index(), 37);
+    ASSERT_EQ(compact.end_index(), 43);
+    ASSERT_EQ(compact.width(), span.width());
+
+    ASSERT_EQ(table.resolve(compact), span);
+    ASSERT_EQ(table.start(compact), Location(3, 4, 37));
+    ASSERT_EQ(table.end(compact), span.end());
+}
+
+TEST(CompactSpan, InternsSources) {
+    const auto first = std::make_shared<StringSource>("first\nsource");
+    const auto second = std::make_shared<StringSource>("second\nsource");
+    auto table = SourceTable();
+
+    ASSERT_EQ(table.add(first), 0);
+    ASSERT_EQ(table.add(second), 1);
+    ASSERT_EQ(table.add(first), 0);
+    ASSERT_EQ(table.size(), 2);
+    ASSERT_EQ(table.source(1), second);
+    EXPECT_THROW((void) table.source(2), std::runtime_error);
+
+    const auto a = table.compact(Span(second, 0, 6));
+    const auto b = table.compact(Span(second, 4, 10));
+    const auto c = table.compact(Span(first, 0, 5));
+    ASSERT_TRUE(a.intersects(b));
+    ASSERT_FALSE(a.intersects(c));
+    ASSERT_EQ(a.join(b), CompactSpan(1, 0, 10));
+    ASSERT_TRUE(c < a);
+    EXPECT_THROW((void) a.join(c), std::runtime_error);
+    EXPECT_THROW((void) CompactSpan(0, 5, 4), std::runtime_error);
+}
+
+TEST(CompactSpan, BorrowedSources) {
+    const auto file_source = std::make_shared<FileSource>(RESOURCES_DIRECTORY / "01-main.c", TEST_PATH);
+    auto table = SourceTable();
+
+    const auto compact = table.compact(Span(file_source, 37, 43));
+    const auto owners = file_source.use_count();
+
+    // Borrowed handles have no reference count, copying spans and labels leaves the owners untouched.
+    const auto span = table.resolve_borrowed(compact);
+    const auto copies = std::vector(16, span);
+    ASSERT_EQ(span.source().use_count(), 0);
+    ASSERT_EQ(file_source.use_count(), owners);
+    ASSERT_EQ(span, table.resolve(compact));
+
+    const auto report = Report::Builder()
+                        .severity(Severity::Error)
+                        .message("Borrowed and owned handles")
+                        .label("borrowed", span)
+                        .label("owned", { file_source, 44, 60 })
+                        .build();
+    ASSERT_EQ(report.file_groups().size(), 1);
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "pretty_diagnostics/index_cache.hpp"
+#include "pretty_diagnostics/mapped_source.hpp"
+#include "pretty_diagnostics/source.hpp"
+
+using namespace pretty_diagnostics;
+
+static const auto CACHE_DIRECTORY = std::filesystem::temp_directory_path() / "pretty_diagnostics_index_cache";
+
+static std::filesystem::path write_file(const std::string& name, const size_t count) {
+    const auto directory = std::filesystem::temp_directory_path() / "pretty_diagnostics_index_cache_files";
+    std::filesystem::create_directories(directory);
+
+    const auto path = directory / name;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    for (size_t line = 0; line < count; ++line) {
+        file << (line % 7 == 0 ? "größe " : "line ") << line << (line % 3 == 0 ? "\r\n" : "\n");
+    }
+
+    return path;
+}
+
+TEST(IndexCache, RestoresFileSource) {
+    std::filesystem::remove_all(CACHE_DIRECTORY);
+    const auto path = write_file("restore.txt", 1'000);
+    const auto config = IndexConfig{ .cache_directory = CACHE_DIRECTORY };
+
+    const auto scanned = FileSource(path, path.parent_path(), config);
+    ASSERT_FALSE(scanned.line_index().is_restored());
+    ASSERT_TRUE(std::filesystem::exists(IndexCache(CACHE_DIRECTORY).entry_path(path)));
+
+    const auto restored = FileSource(path, path.parent_path(), config);
+    ASSERT_TRUE(restored.line_index().is_restored());
+    ASSERT_EQ(restored.line_count(), scanned.line_count());
+
+    for (const size_t index : { 0, 5, 120, 3'000, 7'777 }) {
+        ASSERT_EQ(restored.from_index(index), scanned.from_index(index));
+    }
+
+    for (size_t row = 0; row < scanned.line_count(); row += 13) {
+        ASSERT_EQ(restored.line(row), scanned.line(row));
+        ASSERT_EQ(restored.line_index().is_ascii(row), scanned.line_index().is_ascii(row));
+    }
+
+    const auto mapped = MappedFileSource(path, path.parent_path(), AccessHint::Normal, config);
+    ASSERT_TRUE(mapped.line_index().is_restored());
+    ASSERT_EQ(mapped.from_index(3'000), scanned.from_index(3'000));
+}
+
+TEST(IndexCache, RejectsStaleEntries) {
+    std::filesystem::remove_all(CACHE_DIRECTORY);
+    const auto path = write_file("stale.txt", 100);
+    const auto cache = IndexCache(CACHE_DIRECTORY);
+    const auto config = IndexConfig{ .cache_directory = CACHE_DIRECTORY };
+
+    (void) FileSource(path, path.parent_path(), config);
+    ASSERT_TRUE(cache.load(path).has_value());
+
+    // A different size invalidates the entry, the next source scans again and replaces it.
+    write_file("stale.txt", 200);
+    ASSERT_FALSE(cache.load(path).has_value());
+
+    const auto rescanned = FileSource(path, path.parent_path(), config);
+    ASSERT_FALSE(rescanned.line_index().is_restored());
+    ASSERT_EQ(rescanned.line_count(), 201);
+    ASSERT_EQ(cache.load(path)->line_starts.size(), 201);
+
+    // A truncated entry is ignored as well.
+    std::filesystem::resize_file(cache.entry_path(path), 100);
+    ASSERT_FALSE(cache.load(path).has_value());
+    ASSERT_FALSE(FileSource(path, path.parent_path(), config).line_index().is_restored());
+}
+
+TEST(IndexCache, KeysEntriesByTheReadStamp) {
+    std::filesystem::remove_all(CACHE_DIRECTORY);
+    const auto path = write_file("changed.txt", 100);
+    const auto cache = IndexCache(CACHE_DIRECTORY);
+
+    const auto read_stamp = stamp_file(path);
+    ASSERT_TRUE(read_stamp.has_value());
+    const auto source = StringSource(std::string(std::filesystem::file_size(path), 'x'));
+
+    // The file changes between reading and storing, the entry keeps describing the contents that were read.
+    write_file("changed.txt", 200);
+    ASSERT_TRUE(cache.store(path, source.line_index(), *read_stamp));
+    ASSERT_TRUE(cache.load(path, *read_stamp).has_value());
+    ASSERT_FALSE(cache.load(path).has_value());
+}
+
+TEST(IndexCache, RejectsMismatchingData) {
+    const std::string contents = "first\nsecond\nthird";
+
+    const auto valid = LineIndex(contents, IndexData{ { 0, 6, 13 }, { false, false, false } });
+    ASSERT_TRUE(valid.is_restored());
+    ASSERT_EQ(valid.line(1), "second");
+
+    // Line starts that don't follow a line feed are discarded and the contents are scanned instead.
+    const auto invalid = LineIndex(contents, IndexData{ { 0, 4, 13 }, { false, false, false } });
+    ASSERT_FALSE(invalid.is_restored());
+    ASSERT_EQ(invalid.line(1), "second");
+    ASSERT_EQ(invalid.line_count(), 3);
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
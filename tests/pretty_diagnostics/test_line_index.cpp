@@ -0,0 +1,234 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pretty_diagnostics/line_index.hpp"
+#include "pretty_diagnostics/source.hpp"
+#include "pretty_diagnostics/utils.hpp"
+
+using namespace pretty_diagnostics;
+
+static std::string generate_lines(const size_t count) {
+    std::string contents;
+    for (size_t line = 0; line < count; ++line) {
+        contents += "line " + std::to_string(line) + (line % 3 == 0 ? "\r\n" : "\n");
+    }
+    return contents;
+}
+
+TEST(LineIndex, KernelsAgree) {
+    std::string contents;
+    for (size_t index = 0; index < 10'000; ++index) {
+        contents += (index * 7919 % 13 == 0) ? '\n' : static_cast<char>('a' + index % 26);
+    }
+    contents += "\n\n\n";
+
+    for (const auto kernel : { ScanKernel::Portable, ScanKernel::SSE2, ScanKernel::AVX2 }) {
+        if (!is_kernel_supported(kernel)) continue;
+
+        // Different offsets and lengths exercise the unaligned heads and scalar tails of the vector loops.
+        for (size_t start = 0; start < 40; start += 3) {
+            const auto input = std::string_view(contents).substr(start, contents.size() - start * 5);
+
+            std::vector<size_t> expected;
+            for (size_t index = 0; index < input.size(); ++index) {
+                if (input[index] == '\n') expected.push_back(start + index + 1);
+            }
+
+            std::vector<size_t> actual = { 0 };
+            find_line_starts(input, start, actual, kernel);
+            actual.erase(actual.begin());
+
+            ASSERT_EQ(count_newlines(input, kernel), expected.size());
+            ASSERT_EQ(actual, expected);
+        }
+    }
+}
+
+TEST(LineIndex, EmptyContents) {
+    const auto index = LineIndex("");
+    ASSERT_EQ(index.line_count(), 1);
+    ASSERT_EQ(index.row(0), 0);
+    ASSERT_EQ(index.line(0), "");
+    ASSERT_FALSE(index.contains_row(1));
+}
+
+TEST(LineIndex, LazyMatchesEager) {
+    const auto contents = generate_lines(50'000);
+
+    const auto eager = LineIndex(contents);
+    const auto lazy = LineIndex(contents, { .mode = IndexMode::Lazy });
+
+    ASSERT_EQ(lazy.row(7), 0);
+    ASSERT_EQ(lazy.line(3), "line 3");
+    ASSERT_TRUE(lazy.contains_row(40'000));
+
+    for (size_t index = 0; index <= contents.size(); index += 97) {
+        ASSERT_EQ(lazy.row(index), eager.row(index));
+    }
+
+    ASSERT_EQ(lazy.line_count(), eager.line_count());
+    ASSERT_EQ(lazy.line(lazy.line_count() - 2), "line 49999");
+    ASSERT_THROW((void) lazy.line(lazy.line_count()), std::runtime_error);
+}
+
+TEST(LineIndex, LazyConcurrentReaders) {
+    const auto contents = generate_lines(200'000);
+
+    const auto eager = LineIndex(contents);
+    const auto lazy = LineIndex(contents, { .mode = IndexMode::Lazy });
+
+    std::vector<std::thread> threads;
+    std::atomic<size_t> mismatches = 0;
+    for (size_t thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&, thread] {
+            for (size_t row = thread; row < 200'000; row += 1'013) {
+                if (lazy.line(row) != eager.line(row)) ++mismatches;
+                if (lazy.row(eager.line_start(row)) != row) ++mismatches;
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+    ASSERT_EQ(mismatches, 0);
+}
+
+TEST(LineIndex, ParallelMatchesSerial) {
+    const auto contents = generate_lines(100'000) + "no trailing line break";
+
+    const auto serial = LineIndex(contents, { .threads = 1 });
+    ASSERT_EQ(serial.line_count(), 100'001);
+
+    for (const size_t threads : { 2, 3, 7, 16 }) {
+        const auto parallel = LineIndex(contents, { .threads = threads, .parallel_threshold = 1 });
+
+        ASSERT_EQ(parallel.line_count(), serial.line_count());
+        for (size_t row = 0; row < serial.line_count(); ++row) {
+            ASSERT_EQ(parallel.line_start(row), serial.line_start(row));
+        }
+    }
+}
+
+TEST(LineIndex, EncodingsAgree) {
+    // Long lines in between, so the compact encoding also has to store multi-byte deltas.
+    auto contents = generate_lines(5'000);
+    contents.insert(contents.size() / 2, std::string(100'000, 'x') + "\n" + std::string(300, 'y') + "\n");
+
+    const auto wide = LineIndex(contents, { .encoding = IndexEncoding::Wide });
+    ASSERT_EQ(wide.encoding(), IndexEncoding::Wide);
+
+    for (const auto encoding : { IndexEncoding::Narrow, IndexEncoding::Compact }) {
+        for (const auto mode : { IndexMode::Eager, IndexMode::Lazy }) {
+            const auto index = LineIndex(contents, { .mode = mode, .encoding = encoding });
+            ASSERT_EQ(index.encoding(), encoding);
+
+            for (size_t offset = 0; offset <= contents.size(); offset += 7) {
+                ASSERT_EQ(index.row(offset), wide.row(offset));
+            }
+
+            ASSERT_EQ(index.line_count(), wide.line_count());
+            for (size_t row = 0; row < wide.line_count(); ++row) {
+                ASSERT_EQ(index.line_start(row), wide.line_start(row));
+                ASSERT_EQ(index.row(wide.line_start(row)), row);
+            }
+        }
+    }
+
+    ASSERT_EQ(LineIndex(contents).encoding(), IndexEncoding::Narrow);
+}
+
+TEST(LineIndex, CompactMemoryUsage) {
+    const auto contents = generate_lines(100'000);
+
+    const auto wide = LineIndex(contents, { .encoding = IndexEncoding::Wide });
+    const auto narrow = LineIndex(contents, { .encoding = IndexEncoding::Narrow });
+    const auto compact = LineIndex(contents, { .encoding = IndexEncoding::Compact });
+
+    ASSERT_GE(wide.memory_usage(), 100'000 * sizeof(size_t));
+    ASSERT_LT(narrow.memory_usage(), wide.memory_usage() / 2 + 100'000 / 8 + 64);
+    ASSERT_LT(compact.memory_usage(), narrow.memory_usage() / 2);
+}
+
+TEST(LineIndex, AsciiRows) {
+    const std::string contents = "int main() {\n    return \"🚀\";\n}\nä";
+
+    for (const auto mode : { IndexMode::Eager, IndexMode::Lazy }) {
+        const auto index = LineIndex(contents, { .mode = mode });
+
+        ASSERT_TRUE(index.is_ascii(0));
+        ASSERT_FALSE(index.is_ascii(1));
+        ASSERT_TRUE(index.is_ascii(2));
+        ASSERT_FALSE(index.is_ascii(3));
+    }
+}
+
+TEST(LineIndex, CheckpointedColumns) {
+    // A single long row mixing ASCII, 2-, 3- and 4-byte characters, plus a shorter one behind the lazy scan chunk.
+    std::string row;
+    for (size_t index = 0; index < 500; ++index) {
+        row += (index % 7 == 0) ? "ä" : (index % 11 == 0) ? "漢" : (index % 13 == 0) ? "🚀" : "x";
+    }
+    const auto contents = row + "\n" + std::string(70'000, 'a') + "ö\n" + row;
+
+    for (const auto mode : { IndexMode::Eager, IndexMode::Lazy }) {
+        const auto index = LineIndex(contents, { .mode = mode });
+
+        ASSERT_FALSE(index.is_ascii(1));
+        ASSERT_EQ(index.to_visual_column(1, 70'002), 70'001);
+        ASSERT_EQ(index.from_visual_column(1, 70'001), 70'002);
+
+        for (const size_t line : { 0, 2 }) {
+            const auto text = index.line(line);
+
+            for (size_t byte_column = 0; byte_column <= text.size() + 1; ++byte_column) {
+                ASSERT_EQ(index.to_visual_column(line, byte_column), to_visual_column(text, byte_column));
+            }
+
+            for (size_t visual_column = 0; visual_column <= visual_width(text) + 1; ++visual_column) {
+                ASSERT_EQ(index.from_visual_column(line, visual_column), from_visual_column(text, visual_column));
+            }
+        }
+    }
+}
+
+TEST(LineIndex, LazyStringSource) {
+    const auto source = StringSource(generate_lines(1'000), "<memory>", { .mode = IndexMode::Lazy });
+
+    ASSERT_TRUE(source.has_line(10));
+    ASSERT_EQ(source.line(10), "line 10");
+    ASSERT_EQ(source.from_index(12), Location(1, 4, 12));
+    ASSERT_EQ(source.line_count(), 1'001);
+    ASSERT_FALSE(source.has_line(1'001));
+}
+
+// BSD 3-Clause License
+//
+// Copyright (c) 2026, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
@@ -1,8 +1,11 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <memory_resource>
 
+#include "pretty_diagnostics/renderer.hpp"
 #include "pretty_diagnostics/report.hpp"
 #include "pretty_diagnostics/source.hpp"
 
@@ -48,6 +51,228 @@ TEST(Report, BuilderCorrect) {
     ASSERT_EQ(line_4_group.labels().size(), 2);
 }
 
+TEST(Report, AllocatesFromArena) {
+    const auto file_path = RESOURCES_DIRECTORY / "01-main.c";
+    const auto file_source = std::make_shared<FileSource>(file_path, TEST_PATH);
+
+    std::pmr::monotonic_buffer_resource arena;
+
+    // Any allocation that bypasses the arena would go to the default resource and throw.
+    const auto previous_resource = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    auto report = std::optional<Report>();
+    EXPECT_NO_THROW({
+        report = Report::Builder(&arena)
+                 .severity(Severity::Warning)
+                 .message("A message that is too long to be stored inline in the string object")
+                 .code("W0001")
+                 .label("A label text that is too long to be stored inline as well", { file_source, 37, 43 })
+                 .label("Another label that ends up in a different line group", { file_source, 10, 17 })
+                 .note("A note that is also kept in the arena together with the rest of the report")
+                 .build();
+    });
+    std::pmr::set_default_resource(previous_resource);
+
+    ASSERT_TRUE(report.has_value());
+    ASSERT_EQ(report->get_allocator().resource(), &arena);
+
+    const auto& file_group = report->file_groups().at(file_source);
+    ASSERT_EQ(file_group.get_allocator().resource(), &arena);
+    ASSERT_EQ(file_group.line_groups().at(3).get_allocator().resource(), &arena);
+    ASSERT_EQ(file_group.line_groups().at(3).labels().begin()->get_allocator().resource(), &arena);
+
+    // Copying a report into another resource moves all of its memory there.
+    const auto copy = Report(*report, std::pmr::new_delete_resource());
+    ASSERT_EQ(copy.file_groups().at(file_source).line_groups().at(0).get_allocator().resource(), std::pmr::new_delete_resource());
+    ASSERT_EQ(copy.message(), report->message());
+
+    // Moving into the same resource takes the memory over, moving into another one copies it there.
+    auto moved = Report(std::move(*report), &arena);
+    ASSERT_EQ(moved.get_allocator().resource(), &arena);
+    ASSERT_EQ(moved.message(), copy.message());
+    report.emplace(std::move(moved), std::pmr::new_delete_resource());
+    ASSERT_EQ(report->file_groups().at(file_source).get_allocator().resource(), std::pmr::new_delete_resource());
+    ASSERT_EQ(report->code(), "W0001");
+
+    auto renderer = TextRenderer(copy);
+    auto copy_stream = std::ostringstream(), arena_stream = std::ostringstream();
+    copy.render(renderer, copy_stream);
+    report->render(renderer, arena_stream);
+    ASSERT_EQ(copy_stream.str(), arena_stream.str());
+}
+
+TEST(Report, GroupsAreSorted) {
+    const auto file_path = RESOURCES_DIRECTORY / "01-main.c";
+    const auto file_source = std::make_shared<FileSource>(file_path, TEST_PATH);
+
+    // Labels added out of order still end up sorted by their line and position.
+    const auto report = Report::Builder()
+                        .message("Labels in reverse order")
+                        .label("Fourth", { file_source, 44, 60 })
+                        .label("Third", { file_source, 37, 43 })
+                        .label("Second", { file_source, 1, 0, 1, 1 })
+                        .label("First", { file_source, 10, 17 })
+                        .build();
+
+    const auto& line_groups = report.file_groups().at(file_source).line_groups();
+    ASSERT_TRUE(std::ranges::is_sorted(line_groups, {}, [](const auto& entry) { return entry.first; }));
+    ASSERT_EQ(line_groups.begin()->first, 0);
+    ASSERT_EQ(line_groups.rbegin()->first, 3);
+    ASSERT_FALSE(line_groups.contains(2));
+
+    const auto& labels = line_groups.at(3).labels();
+    ASSERT_EQ(labels.size(), 2);
+    ASSERT_EQ(labels.begin()->text(), "Third");
+    ASSERT_EQ(labels.rbegin()->text(), "Fourth");
+}
+
+TEST(Report, BuildMovesState) {
+    const auto file_path = RESOURCES_DIRECTORY / "01-main.c";
+    const auto file_source = std::make_shared<FileSource>(file_path, TEST_PATH);
+
+    auto builder = Report::Builder();
+    builder.message("A message that is too long to be stored inline in the string object")
+           .label("A label text that is too long to be stored inline as well", { file_source, 37, 43 });
+
+    const auto copied = builder.build();
+    const auto moved = std::move(builder).build();
+    ASSERT_EQ(moved.message(), copied.message());
+    ASSERT_EQ(moved.severity(), Severity::Error);
+    ASSERT_EQ(moved.file_groups().at(file_source).line_groups().at(3).labels().size(), 1);
+
+    // The builder is left empty and can be used for the next report.
+    ASSERT_THROW((void) builder.build(), std::runtime_error);
+    const auto next = builder.message("Next").label("Next label", { file_source, 10, 17 }).build();
+    ASSERT_EQ(next.file_groups().at(file_source).line_groups().size(), 1);
+    ASSERT_TRUE(next.file_groups().at(file_source).line_groups().contains(0));
+}
+
+TEST(Report, ResetReusesMemory) {
+    const auto file_path = RESOURCES_DIRECTORY / "01-main.c";
+    const auto file_source = std::make_shared<FileSource>(file_path, TEST_PATH);
+    const auto other_source = std::make_shared<StringSource>("int main() {}\n");
+
+    // Counts the bytes that are requested from the builder's resource.
+    class CountingResource final : public std::pmr::memory_resource {
+    public:
+        size_t allocated = 0;
+
+    private:
+        void* do_allocate(const size_t bytes, const size_t alignment) override {
+            allocated += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* pointer, const size_t bytes, const size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    auto resource = CountingResource();
+    auto builder = Report::Builder(&resource);
+
+    const auto fill = [&](Report::Builder& target) -> Report::Builder& {
+        return target.message("Message")
+                     .label("First", { file_source, 10, 17 })
+                     .label("Second", { file_source, 1, 0, 1, 1 })
+                     .label("Third", { file_source, 37, 43 });
+    };
+
+    (void) fill(builder).label("Other", { other_source, 0, 3 }).build();
+    const auto first_cycle = resource.allocated;
+
+    builder.reset();
+    resource.allocated = 0;
+
+    // The lines labelled again still have the storage of their labels, so refilling them doesn't allocate at all.
+    (void) fill(builder);
+    ASSERT_EQ(resource.allocated, 0);
+
+    const auto report = builder.build();
+    ASSERT_LT(resource.allocated, first_cycle);
+
+    // The file that wasn't labelled again doesn't show up in the report.
+    ASSERT_EQ(report.file_groups().size(), 1);
+    ASSERT_EQ(report.file_groups().at(file_source).line_groups().size(), 3);
+}
+
+TEST(Report, RejectsIntersectingLabels) {
+    const auto source = std::make_shared<StringSource>("int value = compute(left, right);\nreturn value;\n");
+
+    auto builder = Report::Builder();
+    builder.message("Intersections").label("Value", { source, 4, 9 }).label("Arguments", { source, 20, 31 });
+
+    ASSERT_THROW(builder.label("Inside", { source, 6, 7 }), std::runtime_error);
+    ASSERT_THROW(builder.label("Across", { source, 8, 21 }), std::runtime_error);
+    ASSERT_THROW(builder.label("Touching the start", { source, 0, 4 }), std::runtime_error);
+    ASSERT_NO_THROW(builder.label("Touching the end", { source, 9, 10 }));
+    ASSERT_NO_THROW(builder.label("Between", { source, 12, 19 }));
+
+    builder.label("Multi-row", { source, 32, 37 });
+    try {
+        builder.label("Inside a multi-row", { source, 33, 33 });
+        FAIL();
+    } catch (const std::runtime_error& error) {
+        ASSERT_STREQ(error.what(), "Report::Builder::label(): currently multi-row spans are not supported");
+    }
+
+    // Many labels on a single line don't rescan the whole line for every new label.
+    const auto line = std::make_shared<StringSource>(std::string(20000, 'x'));
+    auto many = Report::Builder();
+    for (size_t index = 0; index < 20000; index += 2) many.label("Label", { line, index, index + 1 });
+    ASSERT_EQ(many.message("Many").build().file_groups().at(line).line_groups().at(0).labels().size(), 10000);
+}
+
+TEST(Report, AddsLabelsInBulk) {
+    const auto source = std::make_shared<StringSource>("int value = compute(left, right);\nreturn value;\n");
+
+    const auto batch = std::vector<Label>{
+        Label("Return", { source, 34, 40 }),
+        Label("Arguments", { source, 20, 31 }),
+        Label("Value", { source, 4, 9 }),
+    };
+
+    auto builder = Report::Builder();
+    builder.message("Bulk").label("Type", { source, 0, 3 }).labels(batch);
+
+    const auto report = builder.build();
+    const auto& line_groups = report.file_groups().at(source).line_groups();
+    ASSERT_EQ(line_groups.size(), 2);
+    ASSERT_EQ(line_groups.at(0).labels().size(), 3);
+    ASSERT_EQ(line_groups.at(0).labels().begin()->text(), "Type");
+    ASSERT_EQ(line_groups.at(0).labels().rbegin()->text(), "Arguments");
+    ASSERT_EQ(line_groups.at(1).labels().size(), 1);
+
+    // A rejected batch doesn't add any of its labels.
+    const auto intersecting = std::vector<Label>{
+        Label("Call", { source, 12, 19 }),
+        Label("Across", { source, 16, 22 }),
+    };
+    ASSERT_THROW(builder.labels(intersecting), std::runtime_error);
+    ASSERT_THROW(builder.labels(std::vector{ Label("Existing", { source, 2, 5 }) }), std::runtime_error);
+    ASSERT_THROW(builder.labels(std::vector{ Label("", { source, 12, 19 }) }), std::runtime_error);
+
+    // Labels of one batch that start at the same position intersect, instead of one of them being dropped.
+    const auto same_start = std::vector<Label>{
+        Label("Name", { source, 4, 9 }),
+        Label("Assignment", { source, 4, 11 }),
+    };
+    ASSERT_THROW(Report::Builder().labels(same_start), std::runtime_error);
+    ASSERT_NO_THROW(Report::Builder().labels(std::vector{ Label("Empty", { source, 4, 4 }), Label("Again", { source, 4, 4 }) }));
+    ASSERT_EQ(builder.build().file_groups().at(source).line_groups().at(0).labels().size(), 3);
+
+    // The same labels added one by one or in bulk give the same groups.
+    auto sequential = Report::Builder();
+    sequential.message("Bulk");
+    for (const auto& label : batch) sequential.label(label.text(), label.span());
+    const auto one_by_one = sequential.build();
+    const auto bulk = Report::Builder().message("Bulk").labels(batch).build();
+    for (const auto& [line, group] : one_by_one.file_groups().at(source).line_groups()) {
+        ASSERT_TRUE(std::ranges::equal(group.labels(), bulk.file_groups().at(source).line_groups().at(line).labels(), {}, &Label::text, &Label::text));
+    }
+}
+
 // BSD 3-Clause License
 //
 // Copyright (c) 2025, Timo Behrend
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 
+#include "pretty_diagnostics/unicode.hpp"
 #include "pretty_diagnostics/utils.hpp"
 
 using namespace pretty_diagnostics;
@@ -28,6 +29,70 @@ TEST(Utils, StandardErrorWidth) {
     EXPECT_NE(stream_width, std::numeric_limits<size_t>::max());
 }
 
+TEST(Utils, CodepointWidths) {
+    EXPECT_EQ(codepoint_width(U'a'), 1);
+    EXPECT_EQ(codepoint_width(U'\u00E9'), 1);  // é
+    EXPECT_EQ(codepoint_width(U'\u2502'), 1);  // Box drawing, 3 bytes but narrow
+    EXPECT_EQ(codepoint_width(U'\u4E2D'), 2);  // CJK
+    EXPECT_EQ(codepoint_width(U'\uFF21'), 2);  // Fullwidth A
+    EXPECT_EQ(codepoint_width(U'\U0001F600'), 2);
+    EXPECT_EQ(codepoint_width(U'\u0301'), 0);  // Combining acute accent
+    EXPECT_EQ(codepoint_width(U'\u200D'), 0);  // Zero width joiner
+    EXPECT_EQ(codepoint_width(U'\U00020000'), 2);
+    EXPECT_EQ(codepoint_width(U'\U000E0100'), 0);
+
+    EXPECT_EQ(decode_utf8("\xE4\xB8\xAD", 0).code_point, U'\u4E2D');
+    EXPECT_EQ(decode_utf8("\xE4\xB8", 0).byte_count, 1);  // Truncated
+    EXPECT_EQ(decode_utf8("\xC0\xAF", 0).byte_count, 1);  // Overlong
+    EXPECT_EQ(decode_utf8("\xED\xA0\x80", 0).byte_count, 1); // Surrogate
+}
+
+TEST(Utils, GraphemeClusters) {
+    const std::string combining = "e\u0301";
+    EXPECT_EQ(get_visual_char(combining, 0).byte_count, combining.size());
+    EXPECT_EQ(visual_width(combining), 1);
+
+    // Family emoji: man, woman and girl joined by zero width joiners.
+    const std::string family = "\U0001F468\u200D\U0001F469\u200D\U0001F467";
+    EXPECT_EQ(get_visual_char(family, 0).byte_count, family.size());
+    EXPECT_EQ(visual_width(family), 2);
+
+    const std::string flag = "\U0001F1E9\U0001F1EA";
+    EXPECT_EQ(visual_width(flag), 2);
+
+    const std::string skin_tone = "\U0001F44D\U0001F3FD";
+    EXPECT_EQ(visual_width(skin_tone), 2);
+
+    const std::string heart = "\u2764\uFE0F";
+    EXPECT_EQ(visual_width(heart), 2);
+
+    const auto line = "ab" + family + "cd";
+    EXPECT_EQ(to_visual_column(line, 2 + family.size()), 4);
+    EXPECT_EQ(from_visual_column(line, 4), 2 + family.size());
+    EXPECT_EQ(from_visual_column(line, 3), 2);
+}
+
+TEST(Utils, AsciiFastPath) {
+    std::string line;
+    for (size_t index = 0; index < 200; ++index) {
+        line += (index % 17 == 0) ? "\u4E2D" : (index % 23 == 0) ? "e\u0301" : "x";
+    }
+
+    // Every width has to match a decode of one character after another.
+    size_t expected_width = 0;
+    for (size_t index = 0; index < line.size();) {
+        const auto [width, byte_count] = get_visual_char(line, index);
+        EXPECT_EQ(to_visual_column(line, index), expected_width);
+        EXPECT_EQ(from_visual_column(line, expected_width), index);
+
+        expected_width += width;
+        index += byte_count;
+    }
+
+    EXPECT_EQ(visual_width(line), expected_width);
+    EXPECT_EQ(ascii_prefix_length(std::string(100, 'a') + "\u00E9"), 100);
+}
+
 // BSD 3-Clause License
 //
 // Copyright (c) 2026, Timo Behrend